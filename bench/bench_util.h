@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+// Helpers shared by the benchmark and training programs.
+
+// Keeps results observable so the compiler cannot drop the work.
+inline volatile std::size_t gSink = 0;
+template <typename T>
+inline void keep(const T& value) { gSink = gSink + value.size(); }
+inline void keep(bool value) { gSink = gSink + value; }
+inline void keep(int value) { gSink = gSink + static_cast<std::size_t>(value); }
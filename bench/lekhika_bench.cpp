@@ -0,0 +1,383 @@
+// Microbenchmarks for liblekhika.
+//
+//   lekhika-bench [--filter <text>] [--min-time <ms>] [--repetitions <n>]
+//                 [--json <file>|-] [--baseline <file>] [--threshold <pct>]
+//                 [--data-dir <dir>]
+//
+// Reports ns/op (median of the repetitions) and heap bytes/op and
+// allocations/op, counted by replacing the global operator new. SQLite
+// allocates with its own allocator, so dictionary numbers cover only the
+// C++ side. With --baseline, results are compared against a previous --json
+// file and the exit code is 1 if any benchmark got slower than --threshold
+// percent (default 10); the geometric mean of the ratios summarizes the
+// speedup of, say, a PGO build over a plain one.
+
+#include "bench_util.h"
+#include "synthetic_corpus.h"
+
+#include <unicode/unistr.h>
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// ----------------- Allocation counting -----------------
+
+static std::atomic<std::uint64_t> gAllocs{0};
+static std::atomic<std::uint64_t> gAllocBytes{0};
+
+static void* countedAlloc(std::size_t size) {
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// ----------------- Harness -----------------
+
+namespace {
+
+struct Benchmark {
+    std::string name;
+    std::function<void(std::uint64_t)> run; // Runs the operation n times
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double nsPerOp = 0;
+    double bytesPerOp = 0;
+    double allocsPerOp = 0;
+};
+
+double elapsedNs(const std::function<void(std::uint64_t)>& run, std::uint64_t n) {
+    auto start = std::chrono::steady_clock::now();
+    run(n);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+Result measure(const Benchmark& bench, double minTimeNs, int repetitions) {
+    // Grow the batch until one batch takes at least minTime.
+    std::uint64_t n = 1;
+    double ns = elapsedNs(bench.run, n);
+    while (ns < minTimeNs && n < (1ull << 40)) {
+        double factor = ns > 0 ? std::clamp(minTimeNs / ns * 1.2, 2.0, 100.0) : 100.0;
+        n = static_cast<std::uint64_t>(n * factor);
+        ns = elapsedNs(bench.run, n);
+    }
+
+    std::vector<double> samples;
+    std::uint64_t allocs = 0, bytes = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        std::uint64_t a0 = gAllocs.load(), b0 = gAllocBytes.load();
+        samples.push_back(elapsedNs(bench.run, n) / static_cast<double>(n));
+        allocs += gAllocs.load() - a0;
+        bytes += gAllocBytes.load() - b0;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = bench.name;
+    result.iterations = n;
+    result.nsPerOp = samples[samples.size() / 2];
+    double ops = static_cast<double>(n) * repetitions;
+    result.allocsPerOp = allocs / ops;
+    result.bytesPerOp = bytes / ops;
+    return result;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// One benchmark per line, so that readBaseline() needs no JSON library.
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n  \"library_version\": \"" << LEKHIKA_VERSION << "\",\n  \"build\": \"" << LEKHIKA_BUILD_PROFILE
+        << "\",\n  \"simd\": \"" << getSimdLevel() << "\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        char numbers[160];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"iterations\": %llu, \"ns_per_op\": %.2f, \"bytes_per_op\": %.1f, \"allocs_per_op\": %.2f",
+                      static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.bytesPerOp, r.allocsPerOp);
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", " << numbers << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+double jsonNumber(const std::string& line, const std::string& key) {
+    size_t pos = line.find("\"" + key + "\":");
+    return pos == std::string::npos ? 0 : std::atof(line.c_str() + pos + key.size() + 3);
+}
+
+std::map<std::string, Result> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open baseline: " + path);
+    std::map<std::string, Result> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t pos = line.find("\"name\": \"");
+        if (pos == std::string::npos) continue;
+        pos += 9;
+        std::string name;
+        for (; pos < line.size() && line[pos] != '"'; ++pos) {
+            if (line[pos] == '\\' && pos + 1 < line.size()) ++pos;
+            name += line[pos];
+        }
+        Result r;
+        r.name = name;
+        r.nsPerOp = jsonNumber(line, "ns_per_op");
+        r.bytesPerOp = jsonNumber(line, "bytes_per_op");
+        r.allocsPerOp = jsonNumber(line, "allocs_per_op");
+        baseline[name] = r;
+    }
+    return baseline;
+}
+
+// ----------------- Inputs -----------------
+
+const char* kLongText =
+    "nepaal ek sundar desh ho jahaan himaal pahaad ra tarai chhan. yahaa~ dherai jaatjaati ra "
+    "bhaashaa bolne maanchhe ek aapasma milera basdachhan. kathmandu upatyakaa yasko raajdhaani ho "
+    "ra yahaa~ dherai puraanaa mandir, stupa ra darbaar chhan. haraek barsha laakhau~ paryatak "
+    "sagarmaathaa herna ra ghumna aaunchhan.";
+
+const char* kMixedText = "mero naam राम ho, ma 2025 ma {Kathmandu} jaanchhu. के तिमी pani aauchhau?";
+
+const char* kDevanagariText =
+    "नेपाल एक सुन्दर देश हो जहाँ हिमाल पहाड र तराई छन्। यहाँ धेरै जातजाति र भाषा बोल्ने मान्छे "
+    "एक आपसमा मिलेर बस्दछन्। काठमाडौं उपत्यका यसको राजधानी हो।";
+
+const char* kBraceText =
+    "{hello} ma {world} {foo} timi {bar} {C++} ra {Linux} ma {fcitx5} chalaauchhu {IME} {API}";
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter, jsonPath, baselinePath;
+    std::string dataDir = (fs::path(LEKHIKA_SRC_DIR) / "core" / "data").string();
+    double minTimeMs = 200;
+    int repetitions = 3;
+    double threshold = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--min-time" && hasValue) minTimeMs = std::atof(argv[++i]);
+        else if (arg == "--repetitions" && hasValue) repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) threshold = std::atof(argv[++i]);
+        else if (arg == "--data-dir" && hasValue) dataDir = argv[++i];
+        else {
+            std::cerr << "Usage: lekhika-bench [--filter <text>] [--min-time <ms>] [--repetitions <n>]\n"
+                         "                     [--json <file>|-] [--baseline <file>] [--threshold <pct>]\n"
+                         "                     [--data-dir <dir>]" << std::endl;
+            return 1;
+        }
+    }
+
+    Transliteration tl(dataDir);
+    std::vector<Benchmark> benches;
+    auto add = [&benches](std::string name, std::function<void(std::uint64_t)> run) {
+        benches.push_back({std::move(name), std::move(run)});
+    };
+
+    add("transliterate/short", [&tl](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate("namaste")); });
+    add("transliterate/long", [&tl](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate(kLongText)); });
+    add("transliterate/mixed", [&tl](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate(kMixedText)); });
+    // Devanagari pasted into the input passes through untouched.
+    add("transliterate/devanagari", [&tl](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate(kDevanagariText)); });
+    add("transliterate/braces", [&tl](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate(kBraceText)); });
+    // Same input as transliterate/long with the instrumentation counters on; the
+    // difference between the two is the cost of enabling stats.
+    add("transliterate/long+stats", [&tl](std::uint64_t n) {
+        tl.setEnableStats(true);
+        for (std::uint64_t i = 0; i < n; ++i) keep(tl.transliterate(kLongText));
+        tl.setEnableStats(false);
+    });
+
+    static const std::vector<std::string> kSmartWords = {"pani", "gunDy", "ank", "sangha", "ghanTa", "kanchan", "raam", "kitaab"};
+    add("applySmartCorrection", [&tl](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) keep(tl.applySmartCorrection(kSmartWords[i % kSmartWords.size()]));
+    });
+
+    const std::string validWord = "नमस्ते", invalidWord = "नमस्तेabc", punctuated = "नमस्ते।";
+    add("isValidDevanagariWord/valid", [&](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(isValidDevanagariWord(validWord)); });
+    add("isValidDevanagariWord/invalid", [&](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(isValidDevanagariWord(invalidWord)); });
+    const icu::UnicodeString graphemeInput = icu::UnicodeString::fromUTF8("क्षत्रियहरूले नमस्ते");
+    add("graphemeCount", [&](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(graphemeCount(graphemeInput)); });
+    add("sanitizeDevanagariWord", [&](std::uint64_t n) { for (std::uint64_t i = 0; i < n; ++i) keep(sanitizeDevanagariWord(punctuated)); });
+
+#ifdef HAVE_SQLITE3
+    // A private dictionary, so results do not depend on the user's data.
+    fs::path dbPath = fs::temp_directory_path() / ("lekhika-bench-" + std::to_string(::getpid()) + ".akshardb");
+    std::unique_ptr<DictionaryManager> dict;
+    std::vector<std::string> words;
+    // Built on first use, so filtered runs without dictionary benchmarks skip it.
+    auto fixture = [&]() -> DictionaryManager& {
+        if (!dict) {
+            dict = std::make_unique<DictionaryManager>(dbPath.string());
+            const auto vocabulary = SyntheticCorpus(dataDir).vocabulary(20000);
+            dict->beginTransaction();
+            for (const SyntheticWord& w : vocabulary) {
+                words.push_back(w.devanagari);
+                dict->addWord(w.devanagari);
+                if (w.frequency > 1) dict->updateWordFrequency(w.devanagari, w.frequency);
+            }
+            dict->commitTransaction();
+            dict->recordSelection("namaste", "नमस्ते");
+        }
+        return *dict;
+    };
+    {
+        add("DictionaryManager/findWords", [&fixture, &words](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) {
+                const std::string& w = words[i % words.size()];
+                keep(d.findWords(w.substr(0, 3), 7)); // First consonant, UTF-8
+            }
+        });
+        add("DictionaryManager/getWordFrequency/hit", [&fixture, &words](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.getWordFrequency(words[i % words.size()]));
+        });
+        add("DictionaryManager/getWordFrequency/miss", [&fixture](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.getWordFrequency("अआइ"));
+        });
+        add("DictionaryManager/searchWords", [&fixture](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.searchWords("कि"));
+        });
+        add("DictionaryManager/getAllWords/byWord", [&fixture](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.getAllWords(25, 1000, DictionaryManager::ByWord));
+        });
+        add("DictionaryManager/getAllWords/byFrequency", [&fixture](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.getAllWords(25, 1000, DictionaryManager::ByFrequency, false));
+        });
+        add("DictionaryManager/addWord/existing", [&fixture, &words](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            for (std::uint64_t i = 0; i < n; ++i) d.addWord(words[i % 100]);
+        });
+        add("DictionaryManager/lookupSelection", [&fixture](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            std::string out;
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.lookupSelection("namaste", out));
+        });
+        add("DictionaryManager/segmentWords", [&fixture, &words](std::uint64_t n) {
+            DictionaryManager& d = fixture();
+            std::string text = words[1] + words[2] + words[3];
+            for (std::uint64_t i = 0; i < n; ++i) keep(d.segmentWords(text));
+        });
+    }
+#endif
+
+    std::map<std::string, Result> baseline;
+    try {
+        if (!baselinePath.empty()) baseline = readBaseline(baselinePath);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // The table goes to stderr when JSON is written to stdout.
+    std::ostream& table = jsonPath == "-" ? std::cerr : std::cout;
+    char line[256];
+    table << "liblekhika " << LEKHIKA_VERSION << " (" << LEKHIKA_BUILD_PROFILE << ", " << getSimdLevel() << " kernels)"
+          << std::endl;
+    std::snprintf(line, sizeof(line), "%-44s %12s %10s %10s%s", "benchmark", "ns/op", "B/op", "allocs/op",
+                  baseline.empty() ? "" : "   baseline     delta");
+    table << line << std::endl;
+
+    std::vector<Result> results;
+    int regressions = 0;
+    double logRatioSum = 0;
+    int compared = 0;
+    for (const auto& bench : benches) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        Result r = measure(bench, minTimeMs * 1e6, repetitions);
+        results.push_back(r);
+        std::snprintf(line, sizeof(line), "%-44s %12.1f %10.1f %10.2f", r.name.c_str(), r.nsPerOp, r.bytesPerOp, r.allocsPerOp);
+        table << line;
+        auto base = baseline.find(r.name);
+        if (base != baseline.end() && base->second.nsPerOp > 0) {
+            double delta = (r.nsPerOp / base->second.nsPerOp - 1) * 100;
+            bool regressed = delta > threshold;
+            regressions += regressed;
+            logRatioSum += std::log(r.nsPerOp / base->second.nsPerOp);
+            ++compared;
+            std::snprintf(line, sizeof(line), " %10.1f %+8.1f%%%s", base->second.nsPerOp, delta, regressed ? "  REGRESSION" : "");
+            table << line;
+        }
+        table << std::endl;
+    }
+    if (compared > 0) {
+        double ratio = std::exp(logRatioSum / compared);
+        std::snprintf(line, sizeof(line), "geometric mean over %d benchmarks: %.3fx the baseline time (%.2fx speedup)",
+                      compared, ratio, 1 / ratio);
+        table << line << std::endl;
+    }
+
+#ifdef HAVE_SQLITE3
+    dict.reset();
+    std::error_code ec;
+    fs::remove(dbPath, ec);
+#endif
+
+    if (jsonPath == "-") {
+        writeJson(std::cout, results);
+    } else if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out) {
+            std::cerr << "Error: cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+    if (regressions > 0) {
+        std::cerr << regressions << " benchmark(s) slower than the baseline by more than " << threshold << "%" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,347 @@
+// IME keystroke replay simulator.
+//
+//   lekhika-replay [--trace <file>] [--words <n>] [--vocab <n>] [--db <file>]
+//                  [--save-trace <file>] [--limit <n>] [--outliers <n>]
+//                  [--json <file>] [--data-dir <dir>]
+//
+// Replays a typing trace through Transliteration and DictionaryManager the
+// way the input method does: every keystroke re-transliterates the Roman
+// buffer for the preedit and looks up suggestions for it; a commit learns
+// the committed word, and picking a suggestion also remembers the choice.
+// Reports the latency of each keystroke, split by stage, and the slowest
+// keystrokes with their context.
+//
+// Trace format: plain text where each character is a keystroke, except
+//   whitespace     commits the preedit (space, tab or newline)
+//   {BS}           backspace
+//   {PICK n}       commits suggestion n (0-based) instead of the preedit
+//   # ...          comment, at the start of a line
+// Without --trace, a trace is synthesized from a Zipfian vocabulary (see
+// SyntheticCorpus) with occasional typos corrected by backspace and
+// occasional suggestion picks. Unless --db is given, the dictionary is a
+// temporary one pre-filled with --vocab synthetic words. A --db dictionary
+// learns from the replay like a real one would, so pass a copy.
+
+#include "synthetic_corpus.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Event {
+    enum Kind { Key, Backspace, Commit, Pick } kind;
+    char key = 0;
+    int index = 0;
+};
+
+enum Stage { StageTransliterate, StageSuggest, StageLearn, StageCount };
+
+struct Sample {
+    size_t event = 0;
+    Event::Kind kind = Event::Key;
+    std::string buffer; // Roman buffer the keystroke acted on
+    double stageUs[StageCount] = {0, 0, 0};
+    double totalUs = 0;
+};
+
+std::vector<Event> parseTrace(std::istream& in) {
+    std::vector<Event> events;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '#') continue;
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '{') {
+                size_t end = line.find('}', i);
+                std::string tag = end == std::string::npos ? "" : line.substr(i + 1, end - i - 1);
+                if (tag == "BS") {
+                    events.push_back({Event::Backspace});
+                    i = end;
+                    continue;
+                }
+                if (tag.rfind("PICK ", 0) == 0) {
+                    events.push_back({Event::Pick, 0, std::atoi(tag.c_str() + 5)});
+                    i = end;
+                    continue;
+                }
+            }
+            if (c == ' ' || c == '\t') events.push_back({Event::Commit});
+            else events.push_back({Event::Key, c});
+        }
+        events.push_back({Event::Commit}); // Newline
+    }
+    return events;
+}
+
+// Synthesized typing: Zipf-sampled words, ~4% typos fixed with backspace,
+// ~10% of words committed by picking the first suggestion.
+std::string synthesizeTrace(const std::vector<SyntheticWord>& vocab, size_t words) {
+    ZipfSampler zipf(vocab.size());
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string trace;
+    for (size_t w = 0; w < words; ++w) {
+        const std::string& roman = vocab[zipf(rng)].roman;
+        for (char c : roman) {
+            if (percent(rng) < 4) trace += std::string(1, static_cast<char>(letter(rng))) + "{BS}";
+            trace += c;
+        }
+        trace += percent(rng) < 10 ? "{PICK 0}" : " ";
+        if (w % 12 == 11) trace += '\n';
+    }
+    return trace + '\n';
+}
+
+double us(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+const char* kindName(Event::Kind kind) {
+    switch (kind) {
+    case Event::Key: return "key";
+    case Event::Backspace: return "backspace";
+    case Event::Commit: return "commit";
+    case Event::Pick: return "pick";
+    }
+    return "";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string tracePath, dbPath, saveTracePath, jsonPath;
+    std::string dataDir = (fs::path(LEKHIKA_SRC_DIR) / "core" / "data").string();
+    size_t words = 2000, vocabSize = 50000, outliers = 10;
+    int limit = 7;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i], value = argv[i + 1];
+        if (arg == "--trace") tracePath = value;
+        else if (arg == "--words") words = std::stoul(value);
+        else if (arg == "--vocab") vocabSize = std::stoul(value);
+        else if (arg == "--db") dbPath = value;
+        else if (arg == "--save-trace") saveTracePath = value;
+        else if (arg == "--limit") limit = std::stoi(value);
+        else if (arg == "--outliers") outliers = std::stoul(value);
+        else if (arg == "--json") jsonPath = value;
+        else if (arg == "--data-dir") dataDir = value;
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Usage: lekhika-replay [--trace <file>] [--words <n>] [--vocab <n>] [--db <file>]\n"
+                     "                      [--save-trace <file>] [--limit <n>] [--outliers <n>]\n"
+                     "                      [--json <file>] [--data-dir <dir>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        // ---- Trace and dictionary ----
+        std::vector<SyntheticWord> vocab;
+        if (tracePath.empty() || dbPath.empty()) {
+            vocab = SyntheticCorpus(dataDir).vocabulary(vocabSize);
+        }
+        std::string traceText;
+        if (!tracePath.empty()) {
+            std::ifstream in(tracePath);
+            if (!in) throw std::runtime_error("Cannot open trace: " + tracePath);
+            traceText.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        } else {
+            traceText = synthesizeTrace(vocab, words);
+        }
+        if (!saveTracePath.empty()) std::ofstream(saveTracePath) << traceText;
+        std::istringstream traceStream(traceText);
+        std::vector<Event> events = parseTrace(traceStream);
+
+        bool temporary = dbPath.empty();
+        if (temporary) {
+            dbPath = (fs::temp_directory_path() / ("lekhika-replay-" + std::to_string(getpid()) + ".akshardb")).string();
+            DictionaryManager seed(dbPath);
+            std::stringstream tsv;
+            for (const auto& w : vocab) tsv << w.devanagari << '\t' << w.frequency << '\n';
+            seed.importWords(tsv);
+        }
+
+        // ---- Replay ----
+        std::vector<Sample> samples;
+        samples.reserve(events.size());
+        DictionaryManager::Stats dictStats;
+        {
+            Transliteration tl(dataDir);
+            DictionaryManager dict(dbPath);
+            tl.setSelectionMemory(&dict);
+            dict.resetStats();
+            dict.setEnableStats(true);
+
+            std::string buffer, preedit;
+            std::vector<std::string> suggestions;
+            for (size_t e = 0; e < events.size(); ++e) {
+                const Event& ev = events[e];
+                Sample s;
+                s.event = e;
+                s.kind = ev.kind;
+                auto start = Clock::now();
+                if (ev.kind == Event::Key || ev.kind == Event::Backspace) {
+                    if (ev.kind == Event::Key) buffer += ev.key;
+                    else if (!buffer.empty()) buffer.pop_back();
+                    s.buffer = buffer;
+                    auto t0 = Clock::now();
+                    preedit = buffer.empty() ? std::string() : tl.transliterate(buffer);
+                    auto t1 = Clock::now();
+                    suggestions = preedit.empty() ? std::vector<std::string>() : dict.findWords(preedit, limit);
+                    auto t2 = Clock::now();
+                    s.stageUs[StageTransliterate] = us(t0, t1);
+                    s.stageUs[StageSuggest] = us(t1, t2);
+                } else {
+                    if (buffer.empty()) continue; // Nothing to commit
+                    s.buffer = buffer;
+                    auto t0 = Clock::now();
+                    if (ev.kind == Event::Pick && ev.index >= 0 && static_cast<size_t>(ev.index) < suggestions.size()) {
+                        dict.addWord(suggestions[ev.index]);
+                        dict.recordSelection(buffer, suggestions[ev.index]);
+                    } else if (isValidDevanagariWord(preedit)) {
+                        dict.addWord(preedit);
+                    }
+                    s.stageUs[StageLearn] = us(t0, Clock::now());
+                    buffer.clear();
+                    preedit.clear();
+                    suggestions.clear();
+                }
+                s.totalUs = us(start, Clock::now());
+                samples.push_back(std::move(s));
+            }
+            dictStats = dict.getStats();
+        }
+        if (temporary) {
+            std::error_code ec;
+            fs::remove(dbPath, ec);
+        }
+
+        // ---- Report ----
+        size_t counts[4] = {0, 0, 0, 0};
+        for (const auto& s : samples) counts[s.kind]++;
+        std::printf("Replayed %zu keystrokes: %zu keys, %zu backspaces, %zu commits, %zu picks\n\n", samples.size(),
+                    counts[Event::Key], counts[Event::Backspace], counts[Event::Commit], counts[Event::Pick]);
+
+        auto summarize = [&](const char* name, auto value, auto include, FILE* out, std::string* json) {
+            std::vector<double> v;
+            double sum = 0;
+            for (const auto& s : samples) {
+                if (!include(s)) continue;
+                v.push_back(value(s));
+                sum += v.back();
+            }
+            std::sort(v.begin(), v.end());
+            double mean = v.empty() ? 0 : sum / v.size();
+            std::fprintf(out, "%-22s %8zu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, v.size(), mean,
+                         percentile(v, 0.50), percentile(v, 0.90), percentile(v, 0.99), percentile(v, 0.999),
+                         v.empty() ? 0 : v.back());
+            if (json) {
+                char buf[256];
+                std::snprintf(buf, sizeof(buf),
+                              "    {\"name\": \"%s\", \"count\": %zu, \"mean_us\": %.1f, \"p50_us\": %.1f, "
+                              "\"p90_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f, \"max_us\": %.1f}",
+                              name, v.size(), mean, percentile(v, 0.50), percentile(v, 0.90), percentile(v, 0.99),
+                              percentile(v, 0.999), v.empty() ? 0 : v.back());
+                if (!json->empty()) *json += ",\n";
+                *json += buf;
+            }
+        };
+
+        std::string json;
+        std::printf("%-22s %8s %9s %9s %9s %9s %9s %9s\n", "latency (us)", "count", "mean", "p50", "p90", "p99",
+                    "p99.9", "max");
+        auto typing = [](const Sample& s) { return s.kind == Event::Key || s.kind == Event::Backspace; };
+        auto committing = [](const Sample& s) { return s.kind == Event::Commit || s.kind == Event::Pick; };
+        auto all = [](const Sample&) { return true; };
+        summarize("keystroke (all)", [](const Sample& s) { return s.totalUs; }, all, stdout, &json);
+        summarize("keystroke (typing)", [](const Sample& s) { return s.totalUs; }, typing, stdout, &json);
+        summarize("keystroke (commit)", [](const Sample& s) { return s.totalUs; }, committing, stdout, &json);
+        summarize("  transliterate", [](const Sample& s) { return s.stageUs[StageTransliterate]; }, typing, stdout, &json);
+        summarize("  suggest", [](const Sample& s) { return s.stageUs[StageSuggest]; }, typing, stdout, &json);
+        summarize("  learn", [](const Sample& s) { return s.stageUs[StageLearn]; }, committing, stdout, &json);
+
+        // Distribution against the budgets that matter for typing: one frame
+        // at 120 Hz and 60 Hz, and the point where lag becomes noticeable.
+        const double bounds[] = {100, 250, 500, 1000, 2000, 4000, 8333, 16667, 50000};
+        size_t buckets[10] = {0};
+        for (const auto& s : samples) {
+            size_t b = std::upper_bound(std::begin(bounds), std::end(bounds), s.totalUs) - std::begin(bounds);
+            buckets[b]++;
+        }
+        std::printf("\nkeystroke latency distribution\n");
+        double lower = 0;
+        for (size_t b = 0; b < 10; ++b) {
+            double pct = samples.empty() ? 0 : 100.0 * buckets[b] / samples.size();
+            char range[40];
+            if (b < 9) std::snprintf(range, sizeof(range), "%.0f - %.0f us", lower, bounds[b]);
+            else std::snprintf(range, sizeof(range), ">= %.0f us", lower);
+            std::printf("  %-22s %8zu %6.2f%% %s\n", range, buckets[b], pct, std::string(static_cast<size_t>(pct / 2), '#').c_str());
+            if (b < 9) lower = bounds[b];
+        }
+
+        // Tail outliers, with the buffer and stage breakdown for context.
+        std::vector<const Sample*> slowest;
+        for (const auto& s : samples) slowest.push_back(&s);
+        size_t n = std::min(outliers, slowest.size());
+        std::partial_sort(slowest.begin(), slowest.begin() + n, slowest.end(),
+                          [](const Sample* a, const Sample* b) { return a->totalUs > b->totalUs; });
+        std::printf("\nslowest %zu keystrokes\n%8s  %-10s %-20s %10s %14s %10s %10s\n", n, "event", "kind", "buffer",
+                    "total us", "transliterate", "suggest", "learn");
+        for (size_t i = 0; i < n; ++i) {
+            const Sample& s = *slowest[i];
+            std::printf("%8zu  %-10s %-20s %10.1f %14.1f %10.1f %10.1f\n", s.event, kindName(s.kind), s.buffer.c_str(),
+                        s.totalUs, s.stageUs[StageTransliterate], s.stageUs[StageSuggest], s.stageUs[StageLearn]);
+        }
+
+        // The dictionary's own view: per-method latency and what SQLite did.
+        std::printf("\ndictionary methods\n%-18s %8s %9s %9s %9s %9s %10s %10s %8s\n", "method", "calls", "mean us",
+                    "p50 us", "p99 us", "max us", "vm steps", "scan steps", "sorts");
+        for (const auto& [name, m] : dictStats.methods) {
+            const auto& h = m.latency;
+            std::printf("%-18s %8llu %9.1f %9.1f %9.1f %9.1f %10llu %10llu %8llu\n", name.c_str(),
+                        static_cast<unsigned long long>(h.count), h.totalNanoseconds / 1000.0 / h.count,
+                        h.percentileMicros(0.50), h.percentileMicros(0.99), h.maxNanoseconds / 1000.0,
+                        static_cast<unsigned long long>(m.vmSteps), static_cast<unsigned long long>(m.fullScanSteps),
+                        static_cast<unsigned long long>(m.sorts));
+        }
+        std::int64_t lookups = dictStats.cacheHits + dictStats.cacheMisses;
+        std::printf("page cache: %lld hits, %lld misses (%.2f%%), %lld writes, %lld bytes in use\n",
+                    static_cast<long long>(dictStats.cacheHits), static_cast<long long>(dictStats.cacheMisses),
+                    lookups ? 100.0 * dictStats.cacheMisses / lookups : 0.0,
+                    static_cast<long long>(dictStats.cacheWrites), static_cast<long long>(dictStats.cacheUsedBytes));
+
+        if (!jsonPath.empty()) {
+            std::ofstream out(jsonPath);
+            out << "{\n  \"library_version\": \"" << LEKHIKA_VERSION << "\",\n  \"keystrokes\": " << samples.size()
+                << ",\n  \"latency\": [\n" << json << "\n  ]\n}\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,325 @@
+// Dictionary scalability harness.
+//
+//   lekhika-scale [--sizes 10000,100000,1000000] [--threads 1,2,4,8]
+//                 [--duration <ms>] [--json <file>] [--data-dir <dir>]
+//   lekhika-scale generate --words <n> [--tokens <n>] --vocab <file.tsv>
+//                 [--corpus <file.txt>] [--seed <n>] [--data-dir <dir>]
+//
+// For each dictionary size, builds a temporary dictionary from a synthetic
+// Zipfian vocabulary (see SyntheticCorpus), times learnFromFile() on a
+// Zipf-sampled corpus, then runs findWords() and searchWords() from 1..N
+// threads, each with its own DictionaryManager on the same file. Prefixes
+// and search terms come from Zipf-sampled words, as typed text would.
+// Prints p50/p99 latency and throughput per cell and, at the end, one
+// scaling curve per operation.
+//
+// `generate` only writes the vocabulary (word<TAB>frequency, importable with
+// `lekhika-cli import`) and optionally a Zipf-sampled corpus for
+// `learn-from-file`, one token per line.
+
+#include "synthetic_corpus.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Cell {
+    size_t size = 0;
+    std::string op;
+    int threads = 0;
+    std::uint64_t ops = 0;
+    double opsPerSecond = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+};
+
+std::vector<long> parseList(const std::string& s) {
+    std::vector<long> values;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(std::stol(item));
+    }
+    return values;
+}
+
+// First `n` code points of a UTF-8 string.
+std::string utf8Prefix(const std::string& s, int n) {
+    size_t i = 0;
+    while (i < s.size() && n > 0) {
+        ++i;
+        while (i < s.size() && (static_cast<unsigned char>(s[i]) & 0xC0) == 0x80) ++i;
+        --n;
+    }
+    return s.substr(0, i);
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[index];
+}
+
+// learnFromFile() takes one token per line.
+void writeCorpus(const std::string& path, const std::vector<SyntheticWord>& vocab, size_t tokens, std::uint64_t seed) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    ZipfSampler zipf(vocab.size());
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < tokens; ++i) out << vocab[zipf(rng)].devanagari << '\n';
+}
+
+// Runs `query` from `threads` threads for `duration` and collects latencies.
+template <typename Query>
+Cell runCell(const std::string& dbPath, int threads, std::chrono::milliseconds duration,
+             const std::vector<std::string>& terms, Query query) {
+    std::vector<std::vector<double>> latencies(threads);
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    Clock::time_point start;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            DictionaryManager dict(dbPath);
+            ++ready;
+            while (!go) std::this_thread::yield();
+            auto deadline = start + duration;
+            size_t i = static_cast<size_t>(t) * 7919;
+            do {
+                auto t0 = Clock::now();
+                query(dict, terms[i++ % terms.size()]);
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+            } while (Clock::now() < deadline);
+        });
+    }
+    while (ready < threads) std::this_thread::yield();
+    start = Clock::now();
+    go = true;
+    for (auto& w : workers) w.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    Cell cell;
+    cell.threads = threads;
+    cell.ops = all.size();
+    cell.opsPerSecond = all.size() / elapsed;
+    cell.p50Us = percentile(all, 0.50);
+    cell.p99Us = percentile(all, 0.99);
+    cell.maxUs = all.empty() ? 0 : all.back();
+    return cell;
+}
+
+void printCell(const Cell& c) {
+    std::printf("%10zu  %-14s %7d %10llu %12.1f %10.1f %10.1f %10.1f\n", c.size, c.op.c_str(), c.threads,
+                static_cast<unsigned long long>(c.ops), c.opsPerSecond, c.p50Us, c.p99Us, c.maxUs);
+    std::fflush(stdout);
+}
+
+int generate(const std::vector<std::string>& args, const std::string& dataDir) {
+    size_t words = 0, tokens = 0;
+    std::string vocabPath, corpusPath;
+    std::uint64_t seed = 42;
+    for (size_t i = 0; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--words") words = std::stoul(args[i + 1]);
+        else if (args[i] == "--tokens") tokens = std::stoul(args[i + 1]);
+        else if (args[i] == "--vocab") vocabPath = args[i + 1];
+        else if (args[i] == "--corpus") corpusPath = args[i + 1];
+        else if (args[i] == "--seed") seed = std::stoull(args[i + 1]);
+    }
+    if (words == 0 || vocabPath.empty()) {
+        std::cerr << "Usage: lekhika-scale generate --words <n> [--tokens <n>] --vocab <file.tsv> "
+                     "[--corpus <file.txt>] [--seed <n>]" << std::endl;
+        return 1;
+    }
+    auto vocab = SyntheticCorpus(dataDir, seed).vocabulary(words);
+    std::ofstream out(vocabPath);
+    for (const auto& w : vocab) out << w.devanagari << '\t' << w.frequency << '\n';
+    if (!corpusPath.empty()) writeCorpus(corpusPath, vocab, tokens ? tokens : words * 10, seed);
+    std::cerr << "Wrote " << vocab.size() << " words to " << vocabPath << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string dataDir = (fs::path(LEKHIKA_SRC_DIR) / "core" / "data").string();
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--data-dir") dataDir = args[i + 1];
+    }
+    try {
+        if (!args.empty() && args[0] == "generate") {
+            return generate(std::vector<std::string>(args.begin() + 1, args.end()), dataDir);
+        }
+
+        std::vector<long> sizes = {10000, 100000, 1000000};
+        std::vector<long> threadCounts = {1, 2, 4, 8};
+        std::chrono::milliseconds duration(1000);
+        std::string jsonPath;
+        for (size_t i = 0; i + 1 < args.size(); i += 2) {
+            if (args[i] == "--sizes") sizes = parseList(args[i + 1]);
+            else if (args[i] == "--threads") threadCounts = parseList(args[i + 1]);
+            else if (args[i] == "--duration") duration = std::chrono::milliseconds(std::stol(args[i + 1]));
+            else if (args[i] == "--json") jsonPath = args[i + 1];
+            else if (args[i] != "--data-dir") {
+                std::cerr << "Usage: lekhika-scale [--sizes a,b,c] [--threads a,b,c] [--duration <ms>] "
+                             "[--json <file>] [--data-dir <dir>]\n"
+                             "       lekhika-scale generate --words <n> --vocab <file.tsv> ..." << std::endl;
+                return 1;
+            }
+        }
+
+        if (sizes.empty() || threadCounts.empty()) {
+            std::cerr << "Error: --sizes and --threads need at least one value." << std::endl;
+            return 1;
+        }
+        long largest = *std::max_element(sizes.begin(), sizes.end());
+        auto start = Clock::now();
+        // One vocabulary; each size uses its most frequent words.
+        std::vector<SyntheticWord> vocab = SyntheticCorpus(dataDir).vocabulary(largest);
+        std::fprintf(stderr, "Generated %zu words in %.1f s\n", vocab.size(),
+                     std::chrono::duration<double>(Clock::now() - start).count());
+
+        fs::path dir = fs::temp_directory_path() / ("lekhika-scale-" + std::to_string(getpid()));
+        fs::create_directories(dir);
+
+        std::printf("%10s  %-14s %7s %10s %12s %10s %10s %10s\n", "words", "operation", "threads", "ops",
+                    "ops/s", "p50 us", "p99 us", "max us");
+        std::vector<Cell> cells;
+        for (long size : sizes) {
+            std::string dbPath = (dir / ("dict-" + std::to_string(size) + ".akshardb")).string();
+            std::vector<SyntheticWord> words(vocab.begin(), vocab.begin() + size);
+
+            // Bulk import, then learning from running text.
+            Cell import{static_cast<size_t>(size), "import", 1};
+            {
+                std::stringstream tsv;
+                for (const auto& w : words) tsv << w.devanagari << '\t' << w.frequency << '\n';
+                DictionaryManager dict(dbPath);
+                auto t0 = Clock::now();
+                dict.importWords(tsv);
+                double s = std::chrono::duration<double>(Clock::now() - t0).count();
+                import.ops = words.size();
+                import.opsPerSecond = words.size() / s;
+            }
+            cells.push_back(import);
+            printCell(import);
+
+            Cell learn{static_cast<size_t>(size), "learnFromFile", 1};
+            {
+                std::string corpus = (dir / "corpus.txt").string();
+                size_t tokens = std::min<size_t>(size, 1000000);
+                writeCorpus(corpus, words, tokens, size);
+                DictionaryManager dict(dbPath);
+                auto t0 = Clock::now();
+                dict.learnFromFile(corpus);
+                double s = std::chrono::duration<double>(Clock::now() - t0).count();
+                learn.ops = tokens;
+                learn.opsPerSecond = tokens / s;
+                fs::remove(corpus);
+            }
+            cells.push_back(learn);
+            printCell(learn);
+
+            // Query terms: Zipf-sampled words cut to what a user has typed so far.
+            ZipfSampler zipf(words.size());
+            std::mt19937_64 rng(7);
+            std::vector<std::string> prefixes, infixes;
+            for (int i = 0; i < 4096; ++i) {
+                const std::string& w = words[zipf(rng)].devanagari;
+                prefixes.push_back(utf8Prefix(w, 1 + i % 3));
+                std::string rest = w.substr(utf8Prefix(w, 1).size());
+                infixes.push_back(utf8Prefix(rest.empty() ? w : rest, 2));
+            }
+
+            for (long threads : threadCounts) {
+                Cell find = runCell(dbPath, static_cast<int>(threads), duration, prefixes,
+                                    [](DictionaryManager& d, const std::string& term) { d.findWords(term, 7); });
+                find.size = size;
+                find.op = "findWords";
+                cells.push_back(find);
+                printCell(find);
+
+                Cell search = runCell(dbPath, static_cast<int>(threads), duration, infixes,
+                                      [](DictionaryManager& d, const std::string& term) { d.searchWords(term); });
+                search.size = size;
+                search.op = "searchWords";
+                cells.push_back(search);
+                printCell(search);
+            }
+            fs::remove(dbPath);
+        }
+        fs::remove_all(dir);
+
+        // Scaling curves: one row per size, one column per thread count.
+        for (const char* op : {"findWords", "searchWords"}) {
+            std::printf("\n%s: ops/s (p99 us)\n%10s", op, "words");
+            for (long t : threadCounts) std::printf(" %20s", (std::to_string(t) + " thread(s)").c_str());
+            std::printf("\n");
+            for (long size : sizes) {
+                std::printf("%10ld", size);
+                for (long t : threadCounts) {
+                    for (const auto& c : cells) {
+                        if (c.op == op && c.size == static_cast<size_t>(size) && c.threads == t) {
+                            char buf[32];
+                            std::snprintf(buf, sizeof(buf), "%.0f (%.0f)", c.opsPerSecond, c.p99Us);
+                            std::printf(" %20s", buf);
+                        }
+                    }
+                }
+                std::printf("\n");
+            }
+        }
+        std::printf("\nimport / learnFromFile: words per second\n");
+        for (long size : sizes) {
+            std::printf("%10ld", size);
+            for (const auto& c : cells) {
+                if (c.size == static_cast<size_t>(size) && (c.op == "import" || c.op == "learnFromFile")) {
+                    std::printf(" %14s %12.0f", c.op.c_str(), c.opsPerSecond);
+                }
+            }
+            std::printf("\n");
+        }
+
+        if (!jsonPath.empty()) {
+            std::ofstream out(jsonPath);
+            out << "{\n  \"library_version\": \"" << LEKHIKA_VERSION << "\",\n  \"cells\": [\n";
+            for (size_t i = 0; i < cells.size(); ++i) {
+                const Cell& c = cells[i];
+                char line[256];
+                std::snprintf(line, sizeof(line),
+                              "    {\"words\": %zu, \"operation\": \"%s\", \"threads\": %d, \"ops\": %llu, "
+                              "\"ops_per_second\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}",
+                              c.size, c.op.c_str(), c.threads, static_cast<unsigned long long>(c.ops),
+                              c.opsPerSecond, c.p50Us, c.p99Us, c.maxUs);
+                out << line << (i + 1 < cells.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
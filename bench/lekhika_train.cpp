@@ -0,0 +1,233 @@
+// Training workload for profile-guided builds of liblekhika.
+//
+//   lekhika-train [--validation <file>] [--words <n>] [--vocab <n>]
+//                 [--passes <n>] [--data-dir <dir>]
+//
+// Drives the library through the work it does in the input method and the
+// command-line tool, so that a LEKHIKA_PGO=GENERATE build records a
+// representative profile: validation and sanitizing of the words in
+// validation_test.txt, transliteration of running text built from the
+// mapping tables (with digits, punctuation, braces and Devanagari mixed in,
+// under each option combination), keystroke-by-keystroke typing with
+// suggestions, learning and selection memory, and the dictionary's import,
+// learning, segmentation and listing paths. The output is deterministic, so
+// two training runs produce the same profile. Run it through the pgo-train
+// target rather than by hand; see "Optimized Builds" in README.md.
+
+#include "bench_util.h"
+#include "synthetic_corpus.h"
+
+#include <unicode/unistr.h>
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Words of validation_test.txt, valid and invalid alike; headers and comments skipped.
+std::vector<std::string> readValidationWords(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open validation file: " + path);
+    std::vector<std::string> words;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line.rfind("---", 0) == 0) continue;
+        words.push_back(line);
+    }
+    return words;
+}
+
+// Running Roman text: Zipf-sampled words with the punctuation, numbers,
+// braced passthrough and pasted Devanagari that real input contains.
+std::vector<std::string> synthesizeSentences(const std::vector<SyntheticWord>& vocab, size_t count) {
+    static const char* const kPunctuation[] = {".", ",", "?", "!", ";", ":", "-"};
+    static const char* const kBraced[] = {"{Linux}", "{C++}", "{fcitx5}", "{API}", "{Kathmandu}"};
+    ZipfSampler zipf(vocab.size());
+    std::mt19937_64 rng(99);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> length(4, 16);
+    std::vector<std::string> sentences;
+    sentences.reserve(count);
+    for (size_t s = 0; s < count; ++s) {
+        std::string text;
+        int words = length(rng);
+        for (int w = 0; w < words; ++w) {
+            if (!text.empty()) text += ' ';
+            int kind = percent(rng);
+            const SyntheticWord& word = vocab[zipf(rng)];
+            if (kind < 3) text += std::to_string(rng() % 3000);
+            else if (kind < 5) text += kBraced[rng() % 5];
+            else if (kind < 7) text += word.devanagari;
+            else text += word.roman;
+            if (percent(rng) < 8) text += kPunctuation[rng() % 7];
+        }
+        sentences.push_back(text + kPunctuation[rng() % 4]);
+    }
+    return sentences;
+}
+
+double ms(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string dataDir = (fs::path(LEKHIKA_SRC_DIR) / "core" / "data").string();
+    std::string validationPath = (fs::path(LEKHIKA_SRC_DIR) / "validation_test.txt").string();
+    size_t words = 3000, vocabSize = 20000;
+    int passes = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i], value = argv[i + 1];
+        if (arg == "--validation") validationPath = value;
+        else if (arg == "--words") words = std::stoul(value);
+        else if (arg == "--vocab") vocabSize = std::stoul(value);
+        else if (arg == "--passes") passes = std::stoi(value);
+        else if (arg == "--data-dir") dataDir = value;
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Usage: lekhika-train [--validation <file>] [--words <n>] [--vocab <n>]\n"
+                     "                     [--passes <n>] [--data-dir <dir>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        auto start = Clock::now(), phase = start;
+        auto report = [&phase](const char* name, size_t operations) {
+            auto now = Clock::now();
+            std::printf("%-14s %10zu operations %10.1f ms\n", name, operations, ms(phase, now));
+            phase = now;
+        };
+
+        // ---- Validation ----
+        std::vector<std::string> checked = readValidationWords(validationPath);
+        for (int p = 0; p < passes; ++p) {
+            for (const auto& w : checked) {
+                keep(isValidDevanagariWord(w));
+                keep(sanitizeDevanagariWord(w));
+                keep(graphemeCount(icu::UnicodeString::fromUTF8(w)));
+            }
+        }
+        report("validation", checked.size() * passes);
+
+        // ---- Transliteration ----
+        // Single-threaded, so the vocabulary and the profile are reproducible.
+        std::vector<SyntheticWord> vocab = SyntheticCorpus(dataDir, 7).vocabulary(vocabSize, 1);
+        std::vector<std::string> sentences = synthesizeSentences(vocab, words / 4 + 1);
+        Transliteration tl(dataDir);
+        size_t operations = 0;
+        for (int options = 0; options < 4; ++options) {
+            tl.setEnableIndicNumbers(options != 1);
+            tl.setEnableSymbolsTransliteration(options == 2);
+            tl.setEnableSmartCorrection(options != 3);
+            tl.setEnableAutoCorrect(options != 3);
+            for (const auto& s : sentences) keep(tl.transliterate(s));
+            for (size_t i = 0; i < words; ++i) keep(tl.applySmartCorrection(vocab[i % vocab.size()].roman));
+            operations += sentences.size() + words;
+        }
+        tl.setEnableIndicNumbers(true);
+        tl.setEnableSymbolsTransliteration(false);
+        tl.setEnableSmartCorrection(true);
+        tl.setEnableAutoCorrect(true);
+        report("transliterate", operations);
+
+#ifdef HAVE_SQLITE3
+        fs::path dbPath = fs::temp_directory_path() / ("lekhika-train-" + std::to_string(getpid()) + ".akshardb");
+        fs::path textPath = fs::path(dbPath).replace_extension(".txt");
+        {
+            DictionaryManager dict(dbPath.string());
+            std::stringstream tsv;
+            for (const auto& w : vocab) tsv << w.devanagari << '\t' << w.frequency << '\n';
+            keep(static_cast<int>(dict.importWords(tsv)));
+            report("import", vocab.size());
+
+            // ---- Typing ----
+            // The input method's loop, as lekhika-replay runs it: every keystroke
+            // re-transliterates the buffer and looks up suggestions; a commit
+            // learns the word, and every tenth word is a picked suggestion.
+            tl.setSelectionMemory(&dict);
+            ZipfSampler zipf(vocab.size());
+            std::mt19937_64 rng(2024);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::uniform_int_distribution<int> letter('a', 'z');
+            size_t keystrokes = 0;
+            for (size_t w = 0; w < words; ++w) {
+                const std::string& roman = vocab[zipf(rng)].roman;
+                std::string buffer, preedit;
+                std::vector<std::string> suggestions;
+                auto type = [&](const std::string& next) {
+                    buffer = next;
+                    preedit = buffer.empty() ? std::string() : tl.transliterate(buffer);
+                    suggestions = preedit.empty() ? std::vector<std::string>() : dict.findWords(preedit, 7);
+                    ++keystrokes;
+                };
+                for (char c : roman) {
+                    if (percent(rng) < 4) {
+                        type(buffer + static_cast<char>(letter(rng)));
+                        type(buffer.substr(0, buffer.size() - 1)); // Backspace
+                    }
+                    type(buffer + c);
+                }
+                if (percent(rng) < 10 && !suggestions.empty()) {
+                    dict.addWord(suggestions[0]);
+                    dict.recordSelection(buffer, suggestions[0]);
+                } else if (isValidDevanagariWord(preedit)) {
+                    dict.addWord(preedit);
+                }
+            }
+            tl.setSelectionMemory(nullptr);
+            report("typing", keystrokes);
+
+            // ---- Learning and dictionary queries ----
+            {
+                std::ofstream text(textPath);
+                for (const auto& s : sentences) text << tl.transliterate(s) << '\n';
+                for (const auto& w : checked) text << w << '\n';
+            }
+            dict.setSegmentOnLearn(true);
+            keep(static_cast<int>(dict.learnFromFile(textPath.string())));
+            operations = sentences.size() + checked.size();
+            for (size_t i = 0; i + 2 < words && i + 2 < vocab.size(); i += 3) {
+                keep(dict.segmentWords(vocab[i].devanagari + vocab[i + 1].devanagari + vocab[i + 2].devanagari));
+                keep(dict.getWordFrequency(vocab[i].devanagari));
+                ++operations;
+            }
+            for (size_t i = 0; i < std::min<size_t>(50, vocab.size()); ++i) {
+                keep(dict.searchWords(vocab[i].devanagari.substr(0, 3)));
+                keep(dict.getAllWords(25, static_cast<int>(i) * 25, i % 2 ? DictionaryManager::ByFrequency : DictionaryManager::ByWord, i % 3 != 0));
+            }
+            std::stringstream exported;
+            operations += 2 * std::min<size_t>(50, vocab.size()) + dict.exportWords(exported);
+            report("dictionary", operations);
+        }
+        std::error_code ec;
+        fs::remove(dbPath, ec);
+        fs::remove(textPath, ec);
+#endif
+
+        std::printf("%-14s %32.1f ms\n", "total", ms(start, Clock::now()));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "synthetic_corpus.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Returns the quoted key of a `"key" = "value"` line, or "" if there is none.
+std::string tomlKey(const std::string& line) {
+    size_t start = line.find_first_of("\"'");
+    if (start == std::string::npos || start != line.find_first_not_of(" \t")) return "";
+    size_t end = line.find(line[start], start + 1);
+    return end == std::string::npos ? "" : line.substr(start + 1, end - start - 1);
+}
+
+// Rough letter frequencies of written Nepali, most common first. Keys of the
+// mapping not listed here (aliases such as "q" or "x") get the lowest weight.
+const char* const kConsonantOrder[] = {"k", "n", "r", "m", "t", "s", "h", "l", "p", "d", "b", "y", "g", "ch",
+                                       "j", "bh", "v", "dh", "kh", "th", "sh", "T", "gh", "ph", "D", "chh",
+                                       "N", "Sh", "jh", "Th", "Dh", "ksh", "gny"};
+const std::pair<const char*, double> kVowelWeights[] = {{"a", 40}, {"aa", 20}, {"i", 10}, {"e", 8}, {"u", 6},
+                                                        {"o", 5}, {"ee", 4}, {"ai", 2}, {"oo", 2}, {"au", 1}};
+
+double consonantWeight(const std::string& root) {
+    const size_t n = sizeof(kConsonantOrder) / sizeof(kConsonantOrder[0]);
+    for (size_t i = 0; i < n; ++i) {
+        if (root == kConsonantOrder[i]) return 100.0 / (i + 2); // Zipf-like decay
+    }
+    return 0.5;
+}
+
+double vowelWeight(const std::string& vowel) {
+    for (const auto& [key, weight] : kVowelWeights) {
+        if (vowel == key) return weight;
+    }
+    return 0.5;
+}
+
+} // namespace
+
+SyntheticCorpus::SyntheticCorpus(const std::string& dataDir, std::uint64_t seed)
+    : dataDir_(dataDir), seed_(seed) {
+    std::ifstream in(fs::path(dataDir) / "mapping.toml");
+    if (!in) throw std::runtime_error("Cannot open mapping.toml in " + dataDir);
+    std::string line, section;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '[') {
+            section = line.substr(1, line.find(']') - 1);
+            continue;
+        }
+        std::string key = tomlKey(line);
+        if (key.empty()) continue;
+        if (section == "consonantMap" && key.size() > 1 && key.back() == 'a') {
+            consonants_.push_back(key.substr(0, key.size() - 1));
+        } else if (section == "charMap" && key.size() <= 2 &&
+                   key.find_first_not_of("aeiou") == std::string::npos) {
+            vowels_.push_back(key);
+        }
+    }
+    if (consonants_.empty() || vowels_.empty()) {
+        throw std::runtime_error("mapping.toml has no consonant or vowel keys");
+    }
+    for (const auto& c : consonants_) consonantWeights_.push_back(consonantWeight(c));
+    for (const auto& v : vowels_) vowelWeights_.push_back(vowelWeight(v));
+}
+
+std::string SyntheticCorpus::romanWord(std::mt19937_64& rng) const {
+    // Mostly two or three syllables, letters skewed like running Nepali text.
+    static const int kSyllableWeights[] = {10, 35, 35, 15, 5};
+    std::discrete_distribution<int> syllables(std::begin(kSyllableWeights), std::end(kSyllableWeights));
+    std::discrete_distribution<size_t> consonant(consonantWeights_.begin(), consonantWeights_.end());
+    std::discrete_distribution<size_t> vowel(vowelWeights_.begin(), vowelWeights_.end());
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::string word;
+    int count = syllables(rng) + 1;
+    for (int s = 0; s < count; ++s) {
+        if (s == 0 && percent(rng) < 8) {
+            word += vowels_[vowel(rng)]; // Word-initial independent vowel
+            continue;
+        }
+        word += consonants_[consonant(rng)];
+        if (percent(rng) < 6) word += consonants_[consonant(rng)]; // Conjunct
+        word += vowels_[vowel(rng)];
+    }
+    if (percent(rng) < 20) word += consonants_[consonant(rng)]; // Closed final syllable
+    return word;
+}
+
+std::vector<SyntheticWord> SyntheticCorpus::vocabulary(size_t count, int jobs) const {
+    if (jobs <= 0) jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<SyntheticWord> words;
+    words.reserve(count);
+    std::unordered_set<std::string> seen;
+    seen.reserve(count * 2);
+
+    // Candidates are generated in rounds; candidate i always comes from the
+    // same seed, so the result does not depend on the number of threads.
+    std::uint64_t next = 0;
+    while (words.size() < count) {
+        size_t round = std::max<size_t>((count - words.size()) * 5 / 4, 1024);
+        std::vector<SyntheticWord> candidates(round);
+        std::vector<char> valid(round, 0);
+        auto work = [&](size_t begin, size_t end) {
+            Transliteration tl(dataDir_);
+            for (size_t i = begin; i < end; ++i) {
+                std::mt19937_64 rng(seed_ * 0x9E3779B97F4A7C15ull + next + i);
+                candidates[i].roman = romanWord(rng);
+                candidates[i].devanagari = tl.transliterate(candidates[i].roman);
+                valid[i] = isValidDevanagariWord(candidates[i].devanagari);
+            }
+        };
+        std::vector<std::thread> threads;
+        size_t per = (round + jobs - 1) / jobs;
+        for (int t = 0; t < jobs; ++t) {
+            size_t begin = t * per, end = std::min(round, begin + per);
+            if (begin < end) threads.emplace_back(work, begin, end);
+        }
+        for (auto& t : threads) t.join();
+        next += round;
+
+        for (size_t i = 0; i < round && words.size() < count; ++i) {
+            if (valid[i] && seen.insert(candidates[i].devanagari).second) {
+                words.push_back(std::move(candidates[i]));
+            }
+        }
+    }
+
+    // Short words are the frequent ones in real text; rank mostly by length.
+    std::mt19937_64 rng(seed_);
+    std::uniform_int_distribution<int> jitter(0, 5);
+    std::vector<std::pair<size_t, size_t>> order;
+    for (size_t i = 0; i < words.size(); ++i) order.emplace_back(words[i].roman.size() + jitter(rng), i);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<SyntheticWord> ranked;
+    ranked.reserve(words.size());
+    for (const auto& entry : order) {
+        ranked.push_back(std::move(words[entry.second]));
+        ranked.back().frequency = zipfFrequency(ranked.size() - 1);
+    }
+    return ranked;
+}
+
+int SyntheticCorpus::zipfFrequency(size_t rank) {
+    // Top word ~1M occurrences, as in a corpus of a few hundred million tokens.
+    double f = 1e6 / std::pow(static_cast<double>(rank + 1), 1.07);
+    return std::max(1, static_cast<int>(f));
+}
+
+ZipfSampler::ZipfSampler(size_t n, double exponent) : cumulative_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+        cumulative_[i] = sum;
+    }
+    for (double& c : cumulative_) c /= sum;
+}
+
+size_t ZipfSampler::operator()(std::mt19937_64& rng) const {
+    double u = std::uniform_real_distribution<double>(0, 1)(rng);
+    size_t rank = std::lower_bound(cumulative_.begin(), cumulative_.end(), u) - cumulative_.begin();
+    return std::min(rank, cumulative_.size() - 1);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One synthetic vocabulary entry: how it is typed and what it yields.
+ */
+struct SyntheticWord {
+    std::string roman;      ///< Roman spelling, built from mapping.toml keys.
+    std::string devanagari; ///< Its transliteration.
+    int frequency = 1;      ///< Zipfian frequency for its rank.
+};
+
+/**
+ * @brief Generates realistic Devanagari vocabularies from the mapping tables.
+ *
+ * Roman words are assembled from the consonant and vowel keys of mapping.toml
+ * (so every syllable is one the engine knows), transliterated with the real
+ * engine, and kept if they are valid, distinct dictionary words. Entries are
+ * returned in rank order with Zipf-distributed frequencies. Output depends
+ * only on the seed.
+ */
+class SyntheticCorpus {
+public:
+    /**
+     * @param dataDir Directory containing mapping.toml.
+     * @param seed Seed for all random choices.
+     */
+    explicit SyntheticCorpus(const std::string& dataDir, std::uint64_t seed = 42);
+
+    /**
+     * @brief Generates `count` distinct words in rank order.
+     * @param jobs Transliteration threads (0 for one per CPU).
+     */
+    std::vector<SyntheticWord> vocabulary(size_t count, int jobs = 0) const;
+
+    /** @brief Zipf frequency of the word at 0-based `rank` (exponent 1.07). */
+    static int zipfFrequency(size_t rank);
+
+private:
+    std::string romanWord(std::mt19937_64& rng) const;
+
+    std::string dataDir_;
+    std::uint64_t seed_;
+    std::vector<std::string> consonants_; // Roman consonant roots ("k", "kh", ...)
+    std::vector<std::string> vowels_;     // Roman vowels ("a", "aa", "i", ...)
+    std::vector<double> consonantWeights_;
+    std::vector<double> vowelWeights_;
+};
+
+/**
+ * @brief Draws 0-based ranks from a Zipf distribution over `n` items.
+ */
+class ZipfSampler {
+public:
+    explicit ZipfSampler(size_t n, double exponent = 1.07);
+    size_t operator()(std::mt19937_64& rng) const;
+
+private:
+    std::vector<double> cumulative_;
+};
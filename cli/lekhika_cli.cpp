@@ -1,19 +1,27 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
 #include <liblekhika/lekhika_core.h>
+#include "lekhika_filter.h"
+#include "lekhika_serve.h"
 
 namespace fs = std::filesystem;
 
 // Forward declaration
 void printHelp();
+int profileMappings(Transliteration& transliterator, const std::vector<std::string>& args);
 
 int main(int argc, char* argv[]) {
     std::vector<std::string> args(argv + 1, argv + argc);
     bool testMode = false;
     std::string dataDir;
     int suggestionLimit = 7; // Default limit
+    std::string tracePath;
 
     // --- Argument Parsing ---
     auto it = args.begin();
@@ -35,16 +43,37 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --limit requires a number." << std::endl;
                 return 1;
             }
+        } else if (*it == "--trace") {
+            it = args.erase(it);
+            if (it == args.end()) {
+                std::cerr << "Error: --trace requires a file path." << std::endl;
+                return 1;
+            }
+            tracePath = *it;
+            it = args.erase(it);
         } else {
             ++it;
         }
     }
+
+    // Declared before any library object, so it is destroyed (and uninstalls itself) last.
+    std::unique_ptr<ChromeTraceSink> traceSink;
+    if (!tracePath.empty()) {
+        try {
+            traceSink = std::make_unique<ChromeTraceSink>(tracePath);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        setTraceSink(traceSink.get());
+    }
     
     if (testMode) {
         #ifdef LEKHIKA_SRC_DIR
             const char* srcDir = LEKHIKA_SRC_DIR;
             dataDir = fs::path(srcDir) / "core" / "data";
-            std::cout << "[Test Mode]: Using local data files from: " << dataDir << std::endl;
+            // stderr, so that exported data on stdout stays clean
+            std::cerr << "[Test Mode]: Using local data files from: " << dataDir << std::endl;
         #else
             std::cerr << "Error: Test mode requires LEKHIKA_SRC_DIR to be set at compile time." << std::endl;
             return 1;
@@ -66,8 +95,54 @@ int main(int argc, char* argv[]) {
     }
     if (command == "--version" || command == "version") {
         std::cout << "liblekhika version " << LEKHIKA_VERSION << std::endl;
+        std::cout << "SIMD kernels: " << getSimdLevel() << std::endl;
         return 0;
     }
+    if (command == "serve") {
+        ServeOptions options;
+        options.socketPath = defaultSocketPath();
+        options.dataDir = dataDir;
+        options.suggestionLimit = suggestionLimit;
+        for (size_t i = 1; i + 1 < args.size(); ++i) {
+            if (args[i] == "--socket") options.socketPath = args[++i];
+            else if (args[i] == "--jobs") {
+                try {
+                    options.jobs = std::stoi(args[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid number for --jobs." << std::endl;
+                    return 1;
+                }
+            }
+        }
+        return runServer(options);
+    }
+    if (command == "filter") {
+        FilterOptions options;
+        options.dataDir = dataDir;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--validate") options.validate = true;
+            else if (args[i] == "--stats") options.stats = true;
+            else if (args[i] == "-0" || args[i] == "--null") options.delimiter = '\0';
+            else if (args[i] == "--use-selections") options.useSelections = true;
+            else if (args[i] == "--jobs" && i + 1 < args.size()) {
+                try {
+                    options.jobs = std::stoi(args[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid number for --jobs." << std::endl;
+                    return 1;
+                }
+            }
+        }
+        options.configure = [args](Transliteration& t) {
+            for (const auto& arg : args) {
+                if (arg == "--disable-smart-correction") t.setEnableSmartCorrection(false);
+                if (arg == "--disable-autocorrect") t.setEnableAutoCorrect(false);
+                if (arg == "--disable-indic-numbers") t.setEnableIndicNumbers(false);
+                if (arg == "--disable-symbols") t.setEnableSymbolsTransliteration(false);
+            }
+        };
+        return runFilter(options);
+    }
 
     Transliteration transliterator(dataDir);
     // Parse transliterator settings
@@ -84,7 +159,48 @@ int main(int argc, char* argv[]) {
             std::cerr << "Usage: lekhika-cli transliterate <text_to_transliterate>" << std::endl;
             return 1;
         }
+#ifdef HAVE_SQLITE3
+        // Remembered selections live in the user dictionary, which opening
+        // would create or migrate, so they are only used on request.
+        std::unique_ptr<DictionaryManager> memory;
+        if (std::find(args.begin(), args.end(), "--use-selections") != args.end()) {
+            try {
+                memory = std::make_unique<DictionaryManager>();
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            transliterator.setSelectionMemory(memory.get());
+        }
+#endif
+        bool stats = std::find(args.begin(), args.end(), "--stats") != args.end();
+        transliterator.setEnableStats(stats);
         std::cout << transliterator.transliterate(args[1]) << std::endl;
+        if (stats) printTransliterationStats(transliterator.getStats(), std::cerr);
+    }
+    else if (command == "profile-mappings") {
+        return profileMappings(transliterator, args);
+    }
+    else if (command == "memory-usage") {
+        auto print = [](const char* title, const MemoryUsage& usage) {
+            std::cout << title << ": " << usage.total() << " bytes" << std::endl;
+            for (const auto& [name, bytes] : usage.bytes) {
+                std::cout << "  " << name << ": " << bytes << std::endl;
+            }
+        };
+        print("transliteration", transliterator.memoryUsage());
+#ifdef HAVE_SQLITE3
+        // Opening the dictionary may create or migrate it, so only on request.
+        if (std::find(args.begin(), args.end(), "--dictionary") != args.end()) {
+            try {
+                DictionaryManager dict;
+                print("dictionary", dict.memoryUsage());
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+#endif
     }
 #ifdef HAVE_SQLITE3
     else { // Dictionary related commands
@@ -99,8 +215,13 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Warning: Input is not a valid Devanagari word. Word not added." << std::endl;
                 return 1;
             }
-            dictManager->addWord(args[1]);
-            std::cout << "Added '" << args[1] << "' to the dictionary." << std::endl;
+            try {
+                dictManager->addWord(args[1]);
+                std::cout << "Added '" << args[1] << "' to the dictionary." << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
         }
         else if (command == "find-word" || command == "suggest") {
             if (args.size() < 2) {
@@ -123,14 +244,199 @@ int main(int argc, char* argv[]) {
             if (args.size() < 2) {
                 std::cerr << "Usage: lekhika-cli learn-from-file <path_to_file>" << std::endl; return 1;
             }
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "--segment") dictManager->setSegmentOnLearn(true);
+            }
+            try {
+                auto job = dictManager->learnFromFileAsync(args[1], [](const DictionaryManager::LearnStats& s) {
+                    int percent = s.totalBytes ? static_cast<int>(s.bytesRead * 100 / s.totalBytes) : 0;
+                    std::cerr << "\rLearning: " << percent << "% (" << s.wordsLearned << " words, "
+                              << static_cast<long>(s.wordsPerSecond) << " words/s)" << std::flush;
+                });
+                auto stats = job.get();
+                std::cerr << std::endl;
+                std::cout << "Successfully learned " << stats.wordsLearned << " new words from " << args[1] << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "merge-db") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: lekhika-cli merge-db <path_to_akshardb> [--policy sum|max|replace]" << std::endl; return 1;
+            }
+            DictionaryManager::MergePolicy policy = DictionaryManager::MergeSum;
+            for (size_t i = 2; i + 1 < args.size(); ++i) {
+                if (args[i] != "--policy") continue;
+                if (args[i + 1] == "max") policy = DictionaryManager::MergeMax;
+                else if (args[i + 1] == "replace") policy = DictionaryManager::MergeReplace;
+                else if (args[i + 1] != "sum") {
+                    std::cerr << "Error: Unknown merge policy '" << args[i + 1] << "'." << std::endl; return 1;
+                }
+            }
+            try {
+                long count = dictManager->mergeFrom(args[1], policy);
+                std::cout << "Merged " << count << " words from " << args[1] << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "export-delta") {
+            if (args.size() < 3) {
+                std::cerr << "Usage: lekhika-cli export-delta <since_seq> <delta_file>" << std::endl; return 1;
+            }
+            try {
+                long long toSeq = dictManager->exportDelta(std::stoll(args[1]), args[2]);
+                std::cout << "Exported changes up to sequence " << toSeq << " to " << args[2] << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "import-delta") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: lekhika-cli import-delta <delta_file>" << std::endl; return 1;
+            }
+            try {
+                long count = dictManager->importDelta(args[1]);
+                std::cout << "Applied " << count << " changes from " << args[1] << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "export" || command == "import") {
+            // Usage: lekhika-cli export|import [--format tsv|binary] [file]; default is stdout/stdin
+            DictionaryManager::WordListFormat format = DictionaryManager::FormatTsv;
+            std::string path;
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "--format" && i + 1 < args.size()) {
+                    if (args[i + 1] == "binary") format = DictionaryManager::FormatBinary;
+                    else if (args[i + 1] != "tsv") {
+                        std::cerr << "Error: Unknown format '" << args[i + 1] << "'." << std::endl; return 1;
+                    }
+                    ++i;
+                } else if (args[i].rfind("--", 0) != 0) {
+                    path = args[i];
+                }
+            }
+            try {
+                if (command == "export") {
+                    std::ofstream file;
+                    if (!path.empty()) {
+                        file.open(path, std::ios::binary | std::ios::trunc);
+                        if (!file.is_open()) {
+                            std::cerr << "Error: Could not open file: " << path << std::endl; return 1;
+                        }
+                    }
+                    long count = dictManager->exportWords(path.empty() ? std::cout : file, format);
+                    std::cerr << "Exported " << count << " words." << std::endl;
+                } else {
+                    std::ifstream file;
+                    if (!path.empty()) {
+                        file.open(path, std::ios::binary);
+                        if (!file.is_open()) {
+                            std::cerr << "Error: Could not open file: " << path << std::endl; return 1;
+                        }
+                    }
+                    long count = dictManager->importWords(path.empty() ? std::cin : file, format);
+                    std::cout << "Imported " << count << " words." << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "backup") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: lekhika-cli backup <destination_path>" << std::endl; return 1;
+            }
+            try {
+                dictManager->backupTo(args[1]);
+                std::cout << "Dictionary backed up to " << args[1] << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "maintain") {
+            int budgetMs = 500;
+            if (args.size() >= 2) {
+                try {
+                    budgetMs = std::stoi(args[1]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Usage: lekhika-cli maintain [budget_ms]" << std::endl; return 1;
+                }
+            }
+            try {
+                auto report = dictManager->maintain(std::chrono::milliseconds(budgetMs));
+                std::cout << "Reclaimed bytes: " << report.bytesReclaimed << std::endl;
+                if (report.reclaimableBytes > 0) {
+                    std::cout << "Reclaimable bytes (incremental vacuum not enabled): " << report.reclaimableBytes << std::endl;
+                }
+                std::cout << "Statistics refreshed: " << (report.analyzed ? "yes" : "no") << std::endl;
+                std::cout << "Indexes rebuilt: " << report.indexesRebuilt << std::endl;
+                std::cout << "Elapsed: " << report.elapsedSeconds * 1000 << " ms"
+                          << (report.complete ? "" : " (budget exhausted, run again)") << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "revalidate") {
+            DictionaryManager::RepairAction action = DictionaryManager::RepairReportOnly;
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "--delete") action = DictionaryManager::RepairDelete;
+                if (args[i] == "--repair") action = DictionaryManager::RepairNormalize;
+            }
+            try {
+                auto report = dictManager->revalidate(action);
+                for (const auto& word : report.sampleOffenders) {
+                    std::cout << "invalid: " << word << std::endl;
+                }
+                std::cout << "Scanned " << report.wordsScanned << " words, " << report.invalidFound << " invalid, "
+                          << report.deleted << " deleted, " << report.normalized << " normalized in "
+                          << report.elapsedSeconds << " s." << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "remember") {
+            if (args.size() < 3) {
+                std::cerr << "Usage: lekhika-cli remember <roman_word> <devanagari_word>" << std::endl; return 1;
+            }
             try {
-                long count = dictManager->learnFromFile(args[1]);
-                std::cout << "Successfully learned " << count << " new words from " << args[1] << std::endl;
+                dictManager->recordSelection(args[1], args[2]);
+                std::cout << "'" << args[1] << "' will now transliterate to '" << args[2] << "'." << std::endl;
             } catch (const std::exception& e) {
                 std::cerr << "Error: " << e.what() << std::endl;
                 return 1;
             }
         }
+        else if (command == "forget") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: lekhika-cli forget <roman_word>" << std::endl; return 1;
+            }
+            try {
+                dictManager->forgetSelection(args[1]);
+                std::cout << "Forgot the remembered selection for '" << args[1] << "'." << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (command == "segment") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: lekhika-cli segment <devanagari_text>" << std::endl; return 1;
+            }
+            auto words = dictManager->segmentWords(args[1]);
+            for (size_t i = 0; i < words.size(); ++i) {
+                std::cout << (i ? " " : "") << words[i];
+            }
+            std::cout << std::endl;
+        }
         else if (command == "list-words") {
             auto words = dictManager->getAllWords(25);
             if (words.empty()) {
@@ -194,15 +500,49 @@ void printHelp() {
     std::cout << "Version: " << getLekhikaVersion() << "\n\n";
     std::cout << "Usage: lekhika-cli [-test] <command> [arguments] [options]\n\n";
     std::cout << "Commands:\n";
-    std::cout << "  transliterate <text>      Transliterates Latin text to Devanagari.\n";
+    std::cout << "  transliterate <text> [--use-selections]\n";
+    std::cout << "                            Transliterates Latin text to Devanagari.\n";
+    std::cout << "                            --use-selections applies outputs saved with 'remember'.\n";
     std::cout << "  version, --version        Display the library version.\n";
+    std::cout << "  memory-usage [--dictionary]\n";
+    std::cout << "                            Shows the memory held by the transliterator.\n";
+    std::cout << "                            --dictionary also opens the dictionary and reports it.\n";
+    std::cout << "  profile-mappings [file] [--top N]\n";
+    std::cout << "                            Transliterates a corpus (default: stdin) and lists the hottest\n";
+    std::cout << "                            and never-used mapping keys, auto-correct words and rules.\n";
     std::cout << "  help                      Show this help message.\n";
+    std::cout << "  filter [--validate] [-0|--null] [--jobs N] [--stats] [--use-selections]\n";
+    std::cout << "                            Transliterates (or validates) each stdin line to stdout, in order.\n";
+    std::cout << "                            -0 uses NUL-delimited records.\n";
+    std::cout << "                            --use-selections applies outputs saved with 'remember'.\n";
+    std::cout << "                            --stats prints per-stage timings and lookup counts to stderr.\n";
+    std::cout << "  serve [--socket <path>] [--jobs N]\n";
+    std::cout << "                            Runs a daemon answering line requests on a Unix socket.\n";
 #ifdef HAVE_SQLITE3
     std::cout << "\nDictionary Commands (require SQLite):\n";
     std::cout << "  add-word <devanagari_word>  Adds a valid Devanagari word to the dictionary.\n";
     std::cout << "  find-word <prefix>        Finds matching words for a prefix.\n";
     std::cout << "  suggest <prefix>          Alias for find-word.\n";
-    std::cout << "  learn-from-file <path>    Learns all valid words from a text file.\n";
+    std::cout << "  learn-from-file <path> [--segment]\n";
+    std::cout << "                            Learns all valid words from a text file.\n";
+    std::cout << "                            --segment splits unspaced runs into known words.\n";
+    std::cout << "  merge-db <path> [--policy sum|max|replace]\n";
+    std::cout << "                            Merges another .akshardb dictionary into yours.\n";
+    std::cout << "  export [--format tsv|binary] [file]\n";
+    std::cout << "                            Streams all words with frequencies (default: stdout).\n";
+    std::cout << "  import [--format tsv|binary] [file]\n";
+    std::cout << "                            Imports words, summing frequencies (default: stdin).\n";
+    std::cout << "  backup <path>             Writes a consistent snapshot of the dictionary to <path>.\n";
+    std::cout << "  remember <roman> <devanagari>\n";
+    std::cout << "                            Always transliterate <roman> to <devanagari>.\n";
+    std::cout << "  forget <roman>            Removes a remembered transliteration.\n";
+    std::cout << "  revalidate [--delete|--repair]\n";
+    std::cout << "                            Re-checks all words; deletes or normalizes invalid ones.\n";
+    std::cout << "  maintain [budget_ms]      Refreshes statistics, reclaims free space and rebuilds an index.\n";
+    std::cout << "  export-delta <seq> <file> Writes dictionary changes made after <seq> to a delta file.\n";
+    std::cout << "                            The first export starts the change log.\n";
+    std::cout << "  import-delta <file>       Applies a delta file exported on another machine.\n";
+    std::cout << "  segment <text>            Splits unspaced Devanagari text into dictionary words.\n";
     std::cout << "  list-words                Lists up to 25 words from the dictionary.\n";
     std::cout << "  search-db <term>          Searches for a term anywhere in a word.\n";
     std::cout << "  db-info                   Displays information and location of the user dictionary.\n";
@@ -216,5 +556,95 @@ void printHelp() {
     std::cout << "  --disable-autocorrect       Disable autocorrect from TOML file.\n";
     std::cout << "  --disable-indic-numbers     Do not transliterate ASCII numbers.\n";
     std::cout << "  --disable-symbols           Do not transliterate symbols.\n";
+    std::cout << "  --stats                     Print transliteration instrumentation counters to stderr.\n";
+    std::cout << "  --trace <file>              Write a Chrome trace (chrome://tracing, Perfetto) of library calls.\n";
 }
 
+
+// Runs a corpus through the transliterator in profiling mode and reports
+// which mapping keys, auto-correct words, rules and paths fired.
+int profileMappings(Transliteration& transliterator, const std::vector<std::string>& args) {
+    size_t top = 25;
+    std::string path;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--top" && i + 1 < args.size()) {
+            try {
+                top = std::stoul(args[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid number for --top." << std::endl;
+                return 1;
+            }
+        } else if (args[i].rfind("--", 0) != 0) {
+            path = args[i];
+        }
+    }
+    std::ifstream file;
+    if (!path.empty()) {
+        file.open(path);
+        if (!file) {
+            std::cerr << "Error: Cannot open " << path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = path.empty() ? std::cin : file;
+
+    transliterator.setEnableProfiling(true);
+    if (!transliterator.isProfilingEnabled()) {
+        std::cerr << "Error: profiling is not available; liblekhika was built with LEKHIKA_STATS=OFF." << std::endl;
+        return 1;
+    }
+    std::string line;
+    size_t lines = 0, bytes = 0;
+    while (std::getline(in, line)) {
+        transliterator.transliterate(line);
+        lines++;
+        bytes += line.size();
+    }
+    auto profile = transliterator.getProfile();
+
+    using Entry = std::pair<std::string, std::uint64_t>;
+    auto byHits = [](const std::map<std::string, std::uint64_t>& hits) {
+        std::vector<Entry> entries(hits.begin(), hits.end());
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.second > b.second; });
+        return entries;
+    };
+    auto printHot = [&](const char* title, const std::map<std::string, std::uint64_t>& hits, size_t limit) {
+        auto entries = byHits(hits);
+        std::uint64_t total = 0;
+        for (const auto& e : entries) total += e.second;
+        std::cout << "\n" << title << " (" << total << " hits)\n";
+        for (size_t i = 0; i < entries.size() && i < limit && entries[i].second > 0; ++i) {
+            std::cout << "  " << std::left << std::setw(28) << entries[i].first << std::right << std::setw(12)
+                      << entries[i].second << std::setw(8) << std::fixed << std::setprecision(2)
+                      << 100.0 * entries[i].second / total << "%\n";
+        }
+    };
+    auto printUnused = [](const char* title, const std::map<std::string, std::uint64_t>& hits) {
+        std::vector<std::string> unused;
+        for (const auto& [key, count] : hits) {
+            if (count == 0) unused.push_back(key);
+        }
+        std::cout << "\n" << title << " (" << unused.size() << " of " << hits.size() << ")\n";
+        size_t width = 0;
+        for (const auto& key : unused) {
+            if (width + key.size() + 1 > 78) {
+                std::cout << "\n";
+                width = 0;
+            }
+            std::cout << (width ? " " : "  ") << key;
+            width += key.size() + (width ? 1 : 2);
+        }
+        if (!unused.empty()) std::cout << "\n";
+    };
+
+    std::cout << "Profiled " << lines << " lines (" << bytes << " bytes).\n";
+    printHot("Paths", profile.pathHits, profile.pathHits.size());
+    printHot("Smart-correction rules", profile.ruleHits, profile.ruleHits.size());
+    printHot("Hottest mapping keys", profile.mappingHits, top);
+    printHot("Hottest auto-correct words", profile.autoCorrectHits, top);
+    printUnused("Never-used mapping keys", profile.mappingHits);
+    printUnused("Never-used auto-correct words", profile.autoCorrectHits);
+    printUnused("Never-used rules", profile.ruleHits);
+    return 0;
+}
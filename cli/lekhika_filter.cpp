@@ -0,0 +1,249 @@
+#include "lekhika_filter.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kChunkSize = 256 * 1024;
+
+struct Chunk {
+    std::string input;
+    std::promise<std::string> output;
+};
+
+// Pool of workers, each owning a Transliteration so that no engine state is
+// shared between threads.
+class FilterPool {
+public:
+    FilterPool(const FilterOptions& options, int jobs) : options_(options) {
+        for (int i = 0; i < jobs; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~FilterPool() { stop(); }
+
+    /// Counters summed over all workers; complete once the pool is stopped.
+    Transliteration::Stats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    std::future<std::string> submit(std::string input) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->input = std::move(input);
+        auto result = chunk->output.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(chunk));
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+private:
+    void run() {
+        std::unique_ptr<Transliteration> transliterator;
+#ifdef HAVE_SQLITE3
+        std::unique_ptr<DictionaryManager> memory;
+#endif
+        std::exception_ptr startError;
+        try {
+            transliterator = std::make_unique<Transliteration>(options_.dataDir);
+            if (options_.configure) options_.configure(*transliterator);
+            transliterator->setEnableStats(options_.stats);
+#ifdef HAVE_SQLITE3
+            // Honour remembered selections on request, as `transliterate` does.
+            if (options_.useSelections && !options_.validate) {
+                memory = std::make_unique<DictionaryManager>();
+                transliterator->setSelectionMemory(memory.get());
+                memory->startChangeWatch(); // A filter can run for a long session
+            }
+#endif
+        } catch (...) {
+            startError = std::current_exception();
+        }
+
+        while (true) {
+            std::unique_ptr<Chunk> chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    if (options_.stats && transliterator) addStats(transliterator->getStats());
+                    return;
+                }
+                chunk = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            if (startError) {
+                chunk->output.set_exception(startError);
+                continue;
+            }
+            try {
+                chunk->output.set_value(process(*transliterator, chunk->input));
+            } catch (...) {
+                chunk->output.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    std::string process(Transliteration& transliterator, const std::string& input) const {
+        const char delimiter = options_.delimiter;
+        std::string out;
+        out.reserve(options_.validate ? input.size() / 4 : input.size() * 3);
+        size_t start = 0;
+        while (start < input.size()) {
+            size_t end = input.find(delimiter, start);
+            if (end == std::string::npos) end = input.size();
+            std::string record = input.substr(start, end - start);
+            if (options_.validate) {
+                out += isValidDevanagariWord(record) ? '1' : '0';
+            } else {
+                out += transliterator.transliterate(record);
+            }
+            out += delimiter;
+            start = end + 1;
+        }
+        return out;
+    }
+
+    // Called with mutex_ held.
+    void addStats(const Transliteration::Stats& s) {
+        stats_.calls += s.calls;
+        stats_.inputBytes += s.inputBytes;
+        stats_.outputBytes += s.outputBytes;
+        stats_.words += s.words;
+        stats_.mapLookups += s.mapLookups;
+        stats_.mapHits += s.mapHits;
+        stats_.autoCorrectHits += s.autoCorrectHits;
+        stats_.selectionHits += s.selectionHits;
+        for (int i = 0; i < Transliteration::StageCount; ++i) {
+            stats_.stages[i].calls += s.stages[i].calls;
+            stats_.stages[i].nanoseconds += s.stages[i].nanoseconds;
+            stats_.stages[i].bytes += s.stages[i].bytes;
+        }
+    }
+
+    const FilterOptions& options_;
+    Transliteration::Stats stats_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::unique_ptr<Chunk>> queue_;
+    bool stopped_ = false;
+};
+
+} // namespace
+
+int runFilter(const FilterOptions& options) {
+    int jobs = options.jobs > 0 ? options.jobs : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    // Bounds memory use while keeping every worker busy.
+    const size_t maxInFlight = static_cast<size_t>(jobs) * 2;
+
+    // Static: stdout keeps using the buffer until exit.
+    static std::vector<char> outBuffer(1 << 20);
+    std::setvbuf(stdout, outBuffer.data(), _IOFBF, outBuffer.size());
+
+    FilterPool pool(options, jobs);
+    std::deque<std::future<std::string>> inFlight;
+    auto writeOldest = [&inFlight]() {
+        std::string out = inFlight.front().get();
+        inFlight.pop_front();
+        return std::fwrite(out.data(), 1, out.size(), stdout) == out.size();
+    };
+
+    std::string buffer;
+    std::vector<char> readBuffer(kChunkSize);
+    try {
+        while (true) {
+            size_t n = std::fread(readBuffer.data(), 1, readBuffer.size(), stdin);
+            buffer.append(readBuffer.data(), n);
+            bool eof = n == 0;
+            // Hand off everything up to the last complete record.
+            size_t take = 0;
+            if (eof) {
+                take = buffer.size();
+            } else if (buffer.size() >= kChunkSize) {
+                size_t last = buffer.rfind(options.delimiter);
+                if (last != std::string::npos) take = last + 1;
+            }
+            if (take > 0) {
+                inFlight.push_back(pool.submit(buffer.substr(0, take)));
+                buffer.erase(0, take);
+                while (inFlight.size() >= maxInFlight) {
+                    if (!writeOldest()) return 1;
+                }
+            }
+            if (eof) break;
+        }
+        while (!inFlight.empty()) {
+            if (!writeOldest()) return 1;
+        }
+    } catch (const std::exception& e) {
+        std::fflush(stdout);
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (options.stats) {
+        pool.stop();
+        printTransliterationStats(pool.stats(), std::cerr);
+    }
+    if (std::ferror(stdin)) {
+        std::cerr << "Error: failed reading standard input." << std::endl;
+        return 1;
+    }
+    return std::fflush(stdout) == 0 ? 0 : 1;
+}
+
+void printTransliterationStats(const Transliteration::Stats& stats, std::ostream& out) {
+    auto ratio = [](std::uint64_t part, std::uint64_t whole) {
+        return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    };
+    std::uint64_t totalNs = 0;
+    for (const auto& stage : stats.stages) totalNs += stage.nanoseconds;
+
+    std::ios state(nullptr);
+    state.copyfmt(out);
+    out << std::fixed << std::setprecision(1);
+    out << "calls " << stats.calls << ", words " << stats.words << ", bytes in " << stats.inputBytes
+        << ", bytes out " << stats.outputBytes << "\n";
+    out << std::left << std::setw(18) << "stage" << std::right << std::setw(12) << "calls" << std::setw(14)
+        << "bytes" << std::setw(12) << "ms" << std::setw(10) << "ns/byte" << std::setw(8) << "%" << "\n";
+    for (int i = 0; i < Transliteration::StageCount; ++i) {
+        const auto& stage = stats.stages[i];
+        out << std::left << std::setw(18) << Transliteration::Stats::stageName(static_cast<Transliteration::Stage>(i))
+            << std::right << std::setw(12) << stage.calls << std::setw(14) << stage.bytes << std::setw(12)
+            << stage.nanoseconds / 1e6 << std::setw(10)
+            << (stage.bytes ? static_cast<double>(stage.nanoseconds) / stage.bytes : 0.0) << std::setw(8)
+            << ratio(stage.nanoseconds, totalNs) << "\n";
+    }
+    out << "map lookups " << stats.mapLookups << ", hits " << stats.mapHits << " ("
+        << ratio(stats.mapHits, stats.mapLookups) << "%)\n";
+    out << "autocorrect hits " << stats.autoCorrectHits << ", selection memory hits " << stats.selectionHits
+        << "\n";
+    out.copyfmt(state);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <functional>
+#include <iosfwd>
+#include <liblekhika/lekhika_core.h>
+#include <string>
+
+/// Options for the `filter` command.
+struct FilterOptions {
+    std::string dataDir;        ///< Mapping data directory ("" for the installed files).
+    int jobs = 0;               ///< Worker threads (0 for one per CPU).
+    bool validate = false;      ///< Emit 1/0 validity instead of transliterating.
+    char delimiter = '\n';      ///< Record separator for input and output.
+    bool stats = false;         ///< Print the workers' combined instrumentation counters to stderr.
+    bool useSelections = false; ///< Apply remembered selections from the user dictionary.
+    /// Applied to each worker's Transliteration (e.g. the --disable-* options).
+    std::function<void(Transliteration&)> configure;
+};
+
+/**
+ * @brief Transliterates (or validates) every record read from stdin and writes
+ * one result per record to stdout, in input order.
+ *
+ * Input is read in large chunks cut at record boundaries; chunks are processed
+ * by a pool of workers, each with its own Transliteration, and their results are
+ * written back in order with one write per chunk.
+ * @return The process exit code.
+ */
+int runFilter(const FilterOptions& options);
+
+/**
+ * @brief Prints instrumentation counters as an aligned table: one line per
+ * pipeline stage, then the lookup and hit counts.
+ */
+void printTransliterationStats(const Transliteration::Stats& stats, std::ostream& out);
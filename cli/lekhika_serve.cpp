@@ -0,0 +1,464 @@
+#include "lekhika_serve.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<bool> stopRequested{false};
+
+// Limits that keep one misbehaving client from holding a worker or growing
+// the daemon's memory without bound.
+constexpr size_t kMaxLineBytes = 64 * 1024;   // Longest request line
+constexpr size_t kMaxPending = 1024;          // Queued requests before reading pauses
+constexpr size_t kMaxPendingBytes = 1 << 20;  // Queued request bytes before reading pauses
+constexpr size_t kMaxResponseBytes = 1 << 20; // Unsent output before a client's requests pause
+constexpr size_t kBatchLines = 64;            // Requests a worker takes per turn
+constexpr auto kSendStall = std::chrono::seconds(5);        // Drop a client that reads nothing for this long
+constexpr auto kAcceptBackoff = std::chrono::seconds(1);    // Pause accepting when out of descriptors
+
+void onSignal(int) { stopRequested = true; }
+
+// One connected client. The event loop reads requests into `pending` and
+// writes `output` to the socket; at most one worker at a time turns pending
+// requests into output, which keeps responses in request order. Workers
+// never touch the socket, so a slow reader cannot hold one.
+struct Client {
+    explicit Client(int fd) : fd(fd) {}
+    ~Client() { close(fd); }
+
+    const int fd;
+    // Event loop only
+    std::string readBuffer;
+    bool readClosed = false; // The client sent EOF; close once answered
+    std::chrono::steady_clock::time_point stalledSince{};
+    // Guarded by mutex
+    std::mutex mutex;
+    std::deque<std::string> pending;
+    size_t pendingBytes = 0;
+    std::string output;
+    bool scheduled = false;
+    bool closed = false; // Dropped by the event loop
+
+    // Caller holds mutex. Whether a worker should pick this client up.
+    bool runnable() const { return !closed && !pending.empty() && output.size() < kMaxResponseBytes; }
+};
+
+// Queue of clients that have pending requests.
+class WorkQueue {
+public:
+    void push(std::shared_ptr<Client> client) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(client));
+        }
+        cv_.notify_one();
+    }
+
+    // Returns nullptr once stopped.
+    std::shared_ptr<Client> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+        if (queue_.empty()) return nullptr;
+        auto client = std::move(queue_.front());
+        queue_.pop_front();
+        return client;
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Client>> queue_;
+    bool stopped_ = false;
+};
+
+// Self-pipe that lets workers wake the event loop's poll() when they have
+// produced output.
+class Wakeup {
+public:
+    Wakeup() {
+        if (pipe2(fds_, O_NONBLOCK | O_CLOEXEC) < 0) fds_[0] = fds_[1] = -1;
+    }
+    ~Wakeup() {
+        if (fds_[0] >= 0) close(fds_[0]);
+        if (fds_[1] >= 0) close(fds_[1]);
+    }
+    bool valid() const { return fds_[0] >= 0; }
+    int fd() const { return fds_[0]; }
+    // A full pipe already guarantees a wakeup, so EAGAIN is fine.
+    void notify() {
+        char c = 0;
+        ssize_t n = write(fds_[1], &c, 1);
+        (void)n;
+    }
+    void drain() {
+        char buffer[256];
+        while (read(fds_[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+private:
+    int fds_[2];
+};
+
+// Per-worker engine state; nothing here is shared between threads.
+class Worker {
+public:
+    explicit Worker(const ServeOptions& options)
+        : transliterator_(options.dataDir), suggestionLimit_(options.suggestionLimit) {
+#ifdef HAVE_SQLITE3
+        try {
+            dict_ = std::make_unique<DictionaryManager>();
+            transliterator_.setSelectionMemory(dict_.get());
+            // Picks up selections recorded by other workers or processes.
+            dict_->startChangeWatch();
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: dictionary unavailable: " << e.what() << std::endl;
+        }
+#endif
+    }
+
+    // Handles one request line and returns the response line (with newline).
+    std::string handle(const std::string& line) {
+        size_t space = line.find(' ');
+        std::string command = line.substr(0, space);
+        std::string arg = space == std::string::npos ? "" : line.substr(space + 1);
+        try {
+            if (command == "ping") return "OK pong\n";
+            if (command == "transliterate") return "OK " + transliterator_.transliterate(arg) + "\n";
+            if (command == "validate") return std::string("OK ") + (isValidDevanagariWord(arg) ? "1" : "0") + "\n";
+#ifdef HAVE_SQLITE3
+            if (command == "suggest" || command == "add-word") {
+                if (!dict_) return "ERR dictionary unavailable\n";
+                if (command == "add-word") {
+                    if (!isValidDevanagariWord(arg)) return "ERR not a valid Devanagari word\n";
+                    dict_->addWord(arg);
+                    return "OK\n";
+                }
+                std::string term = isValidDevanagariWord(arg) ? arg : transliterator_.transliterate(arg);
+                std::string out = "OK";
+                char sep = ' ';
+                for (const auto& word : dict_->findWords(term, suggestionLimit_)) {
+                    out += sep;
+                    out += word;
+                    sep = '\t';
+                }
+                return out + "\n";
+            }
+#endif
+            return "ERR unknown command: " + command + "\n";
+        } catch (const std::exception& e) {
+            return std::string("ERR ") + e.what() + "\n";
+        }
+    }
+
+private:
+    Transliteration transliterator_;
+#ifdef HAVE_SQLITE3
+    std::unique_ptr<DictionaryManager> dict_;
+#endif
+    int suggestionLimit_;
+};
+
+void workerLoop(const ServeOptions& options, WorkQueue& queue, Wakeup& wakeup) {
+    std::unique_ptr<Worker> worker;
+    try {
+        worker = std::make_unique<Worker>(options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: worker failed to start: " << e.what() << std::endl;
+        stopRequested = true;
+        wakeup.notify();
+        return;
+    }
+    std::vector<std::string> batch;
+    std::string response;
+    while (auto client = queue.pop()) {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(client->mutex);
+                if (!client->runnable()) {
+                    // The event loop reschedules the client once its output drains.
+                    client->scheduled = false;
+                    break;
+                }
+                size_t take = std::min(client->pending.size(), kBatchLines);
+                batch.assign(std::make_move_iterator(client->pending.begin()),
+                             std::make_move_iterator(client->pending.begin() + take));
+                client->pending.erase(client->pending.begin(), client->pending.begin() + take);
+                for (const auto& line : batch) client->pendingBytes -= line.size();
+            }
+            // Requests not handled because the response grew too large go
+            // back to the front of the queue.
+            response.clear();
+            size_t handled = 0;
+            while (handled < batch.size() && response.size() < kMaxResponseBytes) {
+                response += worker->handle(batch[handled++]);
+            }
+            {
+                std::lock_guard<std::mutex> lock(client->mutex);
+                client->output += response;
+                for (size_t i = handled; i < batch.size(); ++i) client->pendingBytes += batch[i].size();
+                client->pending.insert(client->pending.begin(),
+                                       std::make_move_iterator(batch.begin() + handled),
+                                       std::make_move_iterator(batch.end()));
+            }
+            wakeup.notify();
+        }
+    }
+}
+
+} // namespace
+
+std::string defaultSocketPath() {
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && runtimeDir[0] != '\0') {
+        return std::string(runtimeDir) + "/lekhika.sock";
+    }
+    return "/tmp/lekhika-" + std::to_string(getuid()) + ".sock";
+}
+
+int runServer(const ServeOptions& options) {
+    sockaddr_un addr{};
+    if (options.socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: socket path too long: " << options.socketPath << std::endl;
+        return 1;
+    }
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, options.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    struct stat st;
+    if (lstat(options.socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "Error: " << options.socketPath << " exists and is not a socket" << std::endl;
+            close(listenFd);
+            return 1;
+        }
+        // Only a socket nobody answers on is stale and safe to replace.
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) close(probe);
+        if (live) {
+            std::cerr << "Error: another server is already listening on " << options.socketPath << std::endl;
+            close(listenFd);
+            return 1;
+        }
+        unlink(options.socketPath.c_str());
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listenFd, 128) < 0) {
+        std::cerr << "Error: cannot listen on " << options.socketPath << ": " << strerror(errno) << std::endl;
+        close(listenFd);
+        return 1;
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+#ifdef HAVE_SQLITE3
+    // Create or migrate the dictionary once, before the workers open it
+    // concurrently. A failure is reported by each worker instead.
+    try {
+        DictionaryManager migrate;
+    } catch (const std::exception&) {
+    }
+#endif
+
+    Wakeup wakeup;
+    if (!wakeup.valid()) {
+        std::cerr << "Error: pipe: " << strerror(errno) << std::endl;
+        close(listenFd);
+        unlink(options.socketPath.c_str());
+        return 1;
+    }
+    WorkQueue queue;
+    int jobs = options.jobs > 0 ? options.jobs : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (int i = 0; i < jobs; ++i) {
+        workers.emplace_back(workerLoop, std::cref(options), std::ref(queue), std::ref(wakeup));
+    }
+    std::cerr << "lekhika-cli: listening on " << options.socketPath << " with " << jobs << " workers" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    std::map<int, std::shared_ptr<Client>> clients;
+    std::vector<pollfd> fds;
+    char buffer[64 * 1024];
+    Clock::time_point acceptPausedUntil{};
+    // The socket closes once no worker holds the client.
+    auto drop = [&](std::map<int, std::shared_ptr<Client>>::iterator it) {
+        std::shared_ptr<Client> client = it->second;
+        clients.erase(it);
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->closed = true;
+        client->pending.clear();
+        client->pendingBytes = 0;
+    };
+    while (!stopRequested) {
+        const auto now = Clock::now();
+        int timeoutMs = 500;
+        fds.clear();
+        fds.push_back({wakeup.fd(), POLLIN, 0});
+        // On EMFILE/ENFILE the listen socket stays readable; stop polling it
+        // for a while instead of spinning on failed accepts.
+        bool accepting = now >= acceptPausedUntil;
+        fds.push_back({listenFd, static_cast<short>(accepting ? POLLIN : 0), 0});
+        if (!accepting) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(acceptPausedUntil - now).count() + 1;
+            timeoutMs = std::min<int>(timeoutMs, static_cast<int>(left));
+        }
+        for (auto it = clients.begin(); it != clients.end();) {
+            auto& client = *it->second;
+            short events = 0;
+            bool idle;
+            {
+                // Reading pauses while the queue or the unsent output is full.
+                std::lock_guard<std::mutex> lock(client.mutex);
+                if (!client.readClosed && client.pending.size() < kMaxPending &&
+                    client.pendingBytes < kMaxPendingBytes &&
+                    client.output.size() < kMaxResponseBytes) {
+                    events |= POLLIN;
+                }
+                if (!client.output.empty()) events |= POLLOUT;
+                idle = client.pending.empty() && client.output.empty() && !client.scheduled;
+            }
+            if (!(events & POLLOUT)) {
+                client.stalledSince = {};
+            } else if (client.stalledSince == Clock::time_point{}) {
+                client.stalledSince = now;
+            } else if (now - client.stalledSince >= kSendStall) {
+                drop(it++); // Stopped reading its responses
+                continue;
+            }
+            if (client.readClosed && idle) {
+                drop(it++); // Sent EOF and has been answered
+                continue;
+            }
+            fds.push_back({it->first, events, 0});
+            ++it;
+        }
+        if (poll(fds.data(), fds.size(), timeoutMs) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: poll: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (fds[0].revents & POLLIN) wakeup.drain();
+        if (fds[1].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                clients[fd] = std::make_shared<Client>(fd);
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                acceptPausedUntil = Clock::now() + kAcceptBackoff;
+            }
+        }
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            auto it = clients.find(fds[i].fd);
+            auto client = it->second;
+            if (fds[i].revents & (POLLERR | POLLNVAL)) {
+                drop(it);
+                continue;
+            }
+            if (fds[i].revents & POLLOUT) {
+                bool reschedule = false;
+                bool failed = false;
+                {
+                    std::lock_guard<std::mutex> lock(client->mutex);
+                    ssize_t n = send(client->fd, client->output.data(), client->output.size(), MSG_NOSIGNAL);
+                    if (n > 0) {
+                        client->output.erase(0, static_cast<size_t>(n));
+                        client->stalledSince = {};
+                        if (!client->scheduled && client->runnable()) {
+                            client->scheduled = true;
+                            reschedule = true;
+                        }
+                    } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                        failed = true;
+                    }
+                }
+                if (failed) {
+                    drop(it);
+                    continue;
+                }
+                if (reschedule) queue.push(client);
+            }
+            if (!(fds[i].revents & (POLLIN | POLLHUP))) continue;
+            ssize_t n = read(client->fd, buffer, sizeof(buffer));
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+            if (n < 0) {
+                drop(it);
+                continue;
+            }
+            if (n == 0) {
+                if (fds[i].revents & POLLHUP) {
+                    drop(it); // Gone entirely; nobody reads the answers
+                } else {
+                    client->readClosed = true; // Half-closed: answer, then close
+                }
+                continue;
+            }
+            client->readBuffer.append(buffer, static_cast<size_t>(n));
+            size_t start = 0, newline;
+            bool queued = false;
+            {
+                std::lock_guard<std::mutex> lock(client->mutex);
+                while ((newline = client->readBuffer.find('\n', start)) != std::string::npos) {
+                    std::string line = client->readBuffer.substr(start, newline - start);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    client->pendingBytes += line.size();
+                    client->pending.push_back(std::move(line));
+                    start = newline + 1;
+                }
+                if (!client->scheduled && client->runnable()) {
+                    client->scheduled = true;
+                    queued = true;
+                }
+            }
+            client->readBuffer.erase(0, start);
+            if (client->readBuffer.size() > kMaxLineBytes) {
+                drop(it); // Request line too long
+                continue;
+            }
+            if (queued) queue.push(client);
+        }
+    }
+
+    queue.stop();
+    for (auto& t : workers) t.join();
+    clients.clear();
+    close(listenFd);
+    unlink(options.socketPath.c_str());
+    return 0;
+}
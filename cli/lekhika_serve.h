@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+
+/// Options for the `serve` command.
+struct ServeOptions {
+    std::string socketPath;   ///< Unix domain socket to listen on.
+    std::string dataDir;      ///< Mapping data directory ("" for the installed files).
+    int jobs = 0;             ///< Worker threads (0 for one per CPU).
+    int suggestionLimit = 7;  ///< Maximum words returned by `suggest`.
+};
+
+/**
+ * @brief Default socket path: $XDG_RUNTIME_DIR/lekhika.sock, or
+ * /tmp/lekhika-<uid>.sock when XDG_RUNTIME_DIR is not set.
+ */
+std::string defaultSocketPath();
+
+/**
+ * @brief Runs the daemon until SIGINT or SIGTERM.
+ *
+ * Clients send one request per line and receive one response line per request,
+ * in order. The main thread multiplexes all connections with poll(); requests are
+ * processed by a pool of workers, each with its own Transliteration and
+ * DictionaryManager, so mapping files and the database are loaded only once.
+ * Responses are written by the main thread as the socket drains, so a client
+ * that reads slowly never holds a worker; its requests wait while 1 MiB of
+ * its output is unsent. Clients that send overlong lines or stop reading
+ * their responses for 5 seconds are disconnected. Fails if another server
+ * already answers on the socket.
+ * @return The process exit code.
+ */
+int runServer(const ServeOptions& options);
@@ -0,0 +1,126 @@
+/********************************************************************
+ * lekhika_c.h  –  lekhika C API
+ ********************************************************************
+Copyright (C) <2025> <Khumnath Cg/nath.khum@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>
+ *******************************************************************/
+/*
+ * Stable C interface for FFI bindings (Python, Rust, C plugins).
+ *
+ * Conventions:
+ *  - Strings are UTF-8 and passed as pointer + length; they need not be
+ *    NUL-terminated.
+ *  - Results are written into a caller-provided buffer. `*out_len` always
+ *    receives the number of bytes the result needs (excluding the NUL). If
+ *    `out_cap` is too small, LEKHIKA_ERR_BUFFER_TOO_SMALL is returned and
+ *    the buffer contents are unspecified; retry with a buffer of at least
+ *    `*out_len + 1` bytes. A NUL is appended whenever there is room.
+ *  - The library never hands out memory the caller must free, apart from
+ *    the handles themselves.
+ *  - A handle must not be used from two threads at once; use one handle per
+ *    thread. Functions without a handle are thread-safe.
+ *  - No function throws; on failure, lekhika_last_error() describes the
+ *    most recent error on the calling thread.
+ */
+#ifndef LEKHIKA_C_H
+#define LEKHIKA_C_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum lekhika_status {
+    LEKHIKA_OK = 0,
+    LEKHIKA_ERR_BUFFER_TOO_SMALL = 1,
+    LEKHIKA_ERR_INVALID_ARGUMENT = 2,
+    LEKHIKA_ERR_FAILED = 3,
+    LEKHIKA_ERR_UNSUPPORTED = 4 /* Built without dictionary support */
+} lekhika_status;
+
+typedef enum lekhika_option {
+    LEKHIKA_OPTION_SMART_CORRECTION = 0,
+    LEKHIKA_OPTION_AUTOCORRECT = 1,
+    LEKHIKA_OPTION_INDIC_NUMBERS = 2,
+    LEKHIKA_OPTION_SYMBOLS = 3
+} lekhika_option;
+
+typedef struct lekhika_transliterator lekhika_transliterator;
+typedef struct lekhika_dictionary lekhika_dictionary;
+
+/* Library version, "MAJOR.MINOR.PATCH". Static storage. */
+const char* lekhika_version(void);
+
+/* Message for the last failed call on this thread ("" if none). Valid until
+ * the next failing call on the same thread. */
+const char* lekhika_last_error(void);
+
+/* ---- Standalone functions ---- */
+
+/* Returns 1 if the text is a valid Devanagari word, 0 otherwise. */
+int lekhika_is_valid_word(const char* word, size_t len);
+
+/* Removes Devanagari punctuation (e.g. danda). */
+lekhika_status lekhika_sanitize_word(const char* word, size_t len,
+                                     char* out, size_t out_cap, size_t* out_len);
+
+/* ---- Transliteration ---- */
+
+/* data_dir may be NULL (or empty) to use the installed mapping files. */
+lekhika_status lekhika_transliterator_new(const char* data_dir, size_t data_dir_len,
+                                          lekhika_transliterator** out);
+void lekhika_transliterator_free(lekhika_transliterator* t);
+
+lekhika_status lekhika_transliterator_set_option(lekhika_transliterator* t,
+                                                 lekhika_option option, int enabled);
+
+/* Transliterates Latin text to Devanagari. The call right after
+ * LEKHIKA_ERR_BUFFER_TOO_SMALL, if it passes the same input, returns the
+ * result already computed instead of redoing the work. */
+lekhika_status lekhika_transliterate(lekhika_transliterator* t,
+                                     const char* input, size_t input_len,
+                                     char* out, size_t out_cap, size_t* out_len);
+
+/* Consults the dictionary's remembered selections before the rules. The
+ * dictionary must outlive its use here; pass NULL to detach. */
+lekhika_status lekhika_transliterator_set_selection_memory(lekhika_transliterator* t,
+                                                           const lekhika_dictionary* d);
+
+/* ---- DictionaryManager ---- */
+
+/* path may be NULL (or empty) for the default user dictionary. */
+lekhika_status lekhika_dictionary_open(const char* path, size_t path_len,
+                                       lekhika_dictionary** out);
+void lekhika_dictionary_free(lekhika_dictionary* d);
+
+/* Add and remove return LEKHIKA_ERR_FAILED if the database write fails. */
+lekhika_status lekhika_dictionary_add_word(lekhika_dictionary* d, const char* word, size_t len);
+lekhika_status lekhika_dictionary_remove_word(lekhika_dictionary* d, const char* word, size_t len);
+lekhika_status lekhika_dictionary_word_frequency(lekhika_dictionary* d, const char* word, size_t len,
+                                                 int* frequency);
+
+/* Words starting with prefix, most frequent first. The words are written
+ * back to back, each followed by a NUL; `*count` receives how many. */
+lekhika_status lekhika_dictionary_find_words(lekhika_dictionary* d,
+                                             const char* prefix, size_t prefix_len, int limit,
+                                             char* out, size_t out_cap, size_t* out_len,
+                                             size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEKHIKA_C_H */
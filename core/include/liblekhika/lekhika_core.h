@@ -21,6 +21,11 @@ along with this program. If not, see <https://www.gnu.org/licenses/>
 #include <vector>
 #include <map>
 #include <memory>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iosfwd>
 
 // Forward declare ICU's UnicodeString to avoid including the full header here
 namespace U_ICU_NAMESPACE {
@@ -37,6 +42,15 @@ class UnicodeString;
  */
 std::string getLekhikaVersion();
 
+/**
+ * @brief Names the instruction set the byte-scanning kernels were dispatched to.
+ *
+ * Chosen once from the running CPU; the LEKHIKA_SIMD environment variable
+ * (`scalar`, `sse2`, `avx2` or `avx512`) caps it, for testing.
+ * @return "scalar", "sse2", "avx2" or "avx512".
+ */
+std::string getSimdLevel();
+
 /**
  * @brief Validates if a string is a well-formed Devanagari word based on orthographic rules.
  * @param u The ICU UnicodeString to validate. This is the core validation logic.
@@ -51,6 +65,13 @@ bool isValidDevanagariWord(const U_ICU_NAMESPACE::UnicodeString &u);
  */
 bool isValidDevanagariWord(const std::string& s);
 
+/**
+ * @brief Counts user-perceived characters (grapheme clusters) in a string.
+ * @param u The ICU UnicodeString to measure.
+ * @return The number of grapheme clusters.
+ */
+int graphemeCount(const U_ICU_NAMESPACE::UnicodeString &u);
+
 /**
  * @brief Removes Devanagari punctuation (like Danda) from a string.
  * @param s The UTF-8 encoded std::string to sanitize.
@@ -65,6 +86,92 @@ std::string sanitizeDevanagariWord(const std::string& s);
  */
 U_ICU_NAMESPACE::UnicodeString sanitizeDevanagariWord(const U_ICU_NAMESPACE::UnicodeString& u);
 
+/**
+ * @brief Approximate memory footprint of an object, by structure.
+ *
+ * Estimated from container sizes and capacities (hash table buckets and
+ * nodes, string payloads stored outside the string object) and from SQLite's
+ * own accounting; allocator overhead is not included. The "*.table" entries
+ * are estimates: node sizes assume libstdc++'s hash table layout (a next
+ * pointer, the value and a cached hash) and may differ on other standard
+ * libraries.
+ */
+struct MemoryUsage {
+    /// Bytes per structure, e.g. "charMap.table" or "sqlite.pageCache".
+    std::map<std::string, std::size_t> bytes;
+
+    /** @brief Sum of all entries. */
+    std::size_t total() const;
+};
+
+
+// =============================================================================//
+// Tracing
+// =============================================================================//
+
+/// One key/value annotation on a trace span.
+struct TraceAttribute {
+    const char* key;   ///< Static string, e.g. "input_bytes".
+    std::string value; ///< Value rendered as text.
+};
+using TraceAttributes = std::vector<TraceAttribute>;
+
+/**
+ * @brief Receives begin/end events for spans around library operations.
+ *
+ * Spans cover transliterate() and its stages ("transliterate",
+ * "transliterate.segment", ...), dictionary queries ("dictionary.findWords",
+ * ...), ingest chunks ("dictionary.learn-chunk", "dictionary.import-batch",
+ * "dictionary.revalidate-chunk") and reloads ("transliteration.load",
+ * "dictionary.reload-selections", "dictionary.rebuild-segmenter"). Names are
+ * static strings. Spans nest per thread: each endSpan() comes on the thread
+ * of its beginSpan(), after the spans begun inside it have ended. Calls may
+ * come from any thread, so implementations must be thread-safe.
+ */
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+    /** @brief Called when a span starts, with its input attributes. */
+    virtual void beginSpan(const char* name, const TraceAttributes& attributes) = 0;
+    /** @brief Called when the span ends, with its result attributes (often none). */
+    virtual void endSpan(const char* name, const TraceAttributes& attributes) = 0;
+};
+
+/**
+ * @brief Installs a process-wide trace sink, or removes it with nullptr.
+ *
+ * Without a sink each span site costs one branch and builds no attributes.
+ * The library does not own the sink: keep it alive until it is removed and
+ * the library calls that started while it was installed have returned.
+ */
+void setTraceSink(TraceSink* sink);
+
+/** @brief Returns the installed trace sink, or nullptr. */
+TraceSink* getTraceSink();
+
+/**
+ * @brief A TraceSink writing Chrome trace event JSON ("B"/"E" events), for
+ * chrome://tracing or Perfetto. A stand-in for local testing: every event is
+ * written under one lock.
+ */
+class ChromeTraceSink : public TraceSink {
+public:
+    /**
+     * @param path File to write the trace to.
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    explicit ChromeTraceSink(const std::string& path);
+    /** @brief Removes itself if it is the installed sink, then completes the file. */
+    ~ChromeTraceSink() override;
+
+    void beginSpan(const char* name, const TraceAttributes& attributes) override;
+    void endSpan(const char* name, const TraceAttributes& attributes) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
 
 #ifdef HAVE_SQLITE3
 
@@ -106,17 +213,25 @@ public:
      * @brief Adds a word to the dictionary. If the word already exists, its
      * frequency count is incremented.
      * @param word The Devanagari word to add.
+     * @throws std::runtime_error if the database write fails (for example,
+     * when another connection holds the write lock for over 5 seconds).
      */
     void addWord(const std::string &word);
 
     /**
      * @brief Removes a word from the dictionary.
      * @param word The word to remove.
+     * @throws std::runtime_error if the database write fails.
      */
     void removeWord(const std::string &word);
 
     /**
      * @brief Finds words in the dictionary that start with a given prefix.
+     *
+     * The prefix is matched exactly, byte for byte: matching is case-sensitive
+     * for Latin letters, and `%` and `_` are ordinary characters, not
+     * wildcards. (Earlier versions used SQL LIKE, which ignored ASCII case
+     * and treated them as wildcards.)
      * @param prefix The Devanagari prefix to search for.
      * @param limit The maximum number of words to return.
      * @return A vector of matching words, sorted by frequency in descending order.
@@ -140,16 +255,345 @@ public:
 
     /**
      * @brief Reads a text file, extracts, sanitizes, validates, and learns valid words.
+     *
+     * Words are committed in small batches, so other writers are never held
+     * off for long. If an error stops the job, the words it already added are
+     * subtracted again.
      * @param filePath The path to the UTF-8 encoded text file.
      * @return The total number of words learned from the file.
      */
     long learnFromFile(const std::string& filePath);
 
+    /// Statistics reported while a background learn job runs, and once it finishes.
+    struct LearnStats {
+        std::uint64_t bytesRead = 0;   ///< Bytes consumed from the input file so far.
+        std::uint64_t totalBytes = 0;  ///< Size of the input file in bytes.
+        long tokensSeen = 0;           ///< Non-empty tokens examined.
+        long wordsLearned = 0;         ///< Tokens that passed validation and were stored.
+        double elapsedSeconds = 0.0;   ///< Wall time since the job started.
+        double wordsPerSecond = 0.0;   ///< Learning rate (wordsLearned / elapsedSeconds).
+        bool cancelled = false;        ///< True if the job stopped early due to cancelLearning().
+        bool committed = false;        ///< True if the learned words were written to the dictionary.
+    };
+
+    /// Progress callback for learnFromFileAsync(). Invoked on the worker thread.
+    using LearnProgressCallback = std::function<void(const LearnStats&)>;
+
+    /**
+     * @brief Learns words from a file on a library-owned worker thread.
+     *
+     * The worker uses its own database connection and commits in batches of
+     * about 20 ms of work (at most 16384 lines or 1 MiB), so writes from other
+     * connections (such as addWord() on this manager) wait for one batch at
+     * most; learned words become visible batch by batch. Cancellation is
+     * checked between batches. A job that fails, or is cancelled without
+     * `commitOnCancel`, subtracts the words it added again. Only one job can run per DictionaryManager at
+     * a time.
+     * @param filePath The path to the UTF-8 encoded text file.
+     * @param onProgress Optional callback, called periodically and once at the end.
+     * @param commitOnCancel If true, words learned before cancellation are kept;
+     * otherwise the words of a cancelled job are subtracted again.
+     * @return A future holding the final statistics. Errors are rethrown from get().
+     * @throws std::runtime_error if the file cannot be opened or a job is already running.
+     */
+    std::future<LearnStats> learnFromFileAsync(const std::string& filePath,
+                                               LearnProgressCallback onProgress = nullptr,
+                                               bool commitOnCancel = false);
+
+    /** @brief Requests cooperative cancellation of the running background learn job. */
+    void cancelLearning();
+
+    /** @brief Returns true while a background learn job is running. */
+    bool isLearning() const;
+
+    /**
+     * @brief Splits unspaced Devanagari text into dictionary words.
+     *
+     * Each whitespace-separated run is segmented with a Viterbi search over a
+     * trie of known words, scored by frequency. Graphemes not covered by any
+     * dictionary word are kept together as a single piece.
+     * @param text The UTF-8 encoded Devanagari text.
+     * @return The segmented words in input order.
+     */
+    std::vector<std::string> segmentWords(const std::string& text);
+
+    /**
+     * @brief Enables segmentation as an ingest stage for learnFromFile() and
+     * learnFromFileAsync(): tokens that split entirely into known words are
+     * learned as those words, and the valid pieces of tokens that fail
+     * validation are learned. Disabled by default.
+     */
+    void setSegmentOnLearn(bool enable);
+
+    /// How mergeFrom() combines the frequency of a word present in both dictionaries.
+    enum MergePolicy { MergeSum = 0, MergeMax = 1, MergeReplace = 2 };
+
+    /**
+     * @brief Merges all words of another .akshardb dictionary into this one.
+     *
+     * The other database is ATTACHed and merged with a single set-based UPSERT
+     * inside one transaction, so even very large dictionaries merge in seconds.
+     * @param otherDbPath The path to the dictionary to merge from.
+     * @param policy How frequencies of words present in both are combined:
+     * summed, the larger one kept, or replaced by the other dictionary's value.
+     * @return The number of words inserted or updated.
+     * @throws std::runtime_error if the other database cannot be attached or read.
+     */
+    long mergeFrom(const std::string& otherDbPath, MergePolicy policy = MergeSum);
+
+    /**
+     * @brief Gets the latest sequence number in the dictionary's change log.
+     *
+     * The change log is opt-in: it is created by the first call to this
+     * function or exportDelta(). From then on every insert, delete and
+     * frequency change is recorded with an increasing sequence number. Store
+     * this value after a full sync and pass it to exportDelta() next time.
+     * Words present before the log was created are not in it, so the first
+     * sequence number of a non-empty dictionary is 1 and exportDelta(0)
+     * refuses to run.
+     * @return The highest sequence number ever recorded (pruning does not
+     * lower it), or 0 if nothing has been logged yet.
+     */
+    long long getChangeSequence();
+
+    /**
+     * @brief Writes all changes made after `sinceSeq` to a compact binary delta file.
+     *
+     * Changes are coalesced per word, so the file size scales with the number
+     * of words changed, not with the size of the dictionary.
+     * Enables the change log if getChangeSequence() has not done so yet.
+     * @param sinceSeq The sequence number of the last sync (0 for the whole log).
+     * @param filePath The delta file to create.
+     * @return The sequence number the delta covers up to; pass it as
+     * `sinceSeq` next time.
+     * @throws std::runtime_error if `sinceSeq` is older than the oldest change
+     * still in the log (see pruneChangeLog()) or than the log itself; sync the
+     * full word list instead.
+     */
+    long long exportDelta(long long sinceSeq, const std::string& filePath);
+
+    /**
+     * @brief Applies a delta file written by exportDelta() on another machine.
+     *
+     * Frequency deltas are added to local counts, deletes remove the word. The
+     * import runs in one transaction and is not itself recorded in the local
+     * change log, so it is not echoed back on the next export.
+     * @param filePath The delta file to apply.
+     * @return The number of records applied.
+     * @throws std::runtime_error if the file is missing or corrupt.
+     */
+    long importDelta(const std::string& filePath);
+
+    /**
+     * @brief Discards change log entries up to and including `uptoSeq`,
+     * once every peer has synced past them.
+     *
+     * The pruned point is remembered, and exportDelta() refuses to start
+     * before it. Does nothing if the change log was never enabled.
+     */
+    void pruneChangeLog(long long uptoSeq);
+
+    /// Word list formats for exportWords() and importWords().
+    enum WordListFormat {
+        FormatTsv = 0,    ///< One "word<TAB>frequency" line per word.
+        FormatBinary = 1  ///< "LKWORDS1" header, then varint length, word bytes, varint frequency per word.
+    };
+
+    /**
+     * @brief Streams every word and its frequency to `out`, in word order.
+     *
+     * Rows are written as they are read from a database cursor, so memory use
+     * does not grow with the dictionary size.
+     * @return The number of words written.
+     */
+    long exportWords(std::ostream& out, WordListFormat format = FormatTsv);
+
+    /**
+     * @brief Streams words from `in` into the dictionary.
+     *
+     * Rows are applied with one prepared UPSERT in a single transaction:
+     * either the whole stream is imported or, on an error, nothing is.
+     * Words that fail validation are skipped. A TSV line without a frequency
+     * counts as 1.
+     * @param policy How to combine the frequency of a word that already exists.
+     * @return The number of words imported.
+     * @throws std::runtime_error on a malformed binary stream or database error;
+     * the dictionary is then left unchanged.
+     */
+    long importWords(std::istream& in, WordListFormat format = FormatTsv, MergePolicy policy = MergeSum);
+
+    /// Progress callback for backupTo(): pages remaining and total page count.
+    using BackupProgressCallback = std::function<void(int remaining, int total)>;
+
+    /**
+     * @brief Writes a consistent snapshot of the dictionary to `destPath` while it stays in use.
+     *
+     * Copies `pagesPerStep` pages at a time with the SQLite online backup API
+     * and yields between steps, so other connections to the database (another
+     * DictionaryManager, the input method in another process) are only held
+     * up for the duration of one step. This manager itself must not be used
+     * from other threads until the call returns. The snapshot is written to a
+     * temporary file and renamed into place when complete.
+     * @param destPath The path of the backup file (replaced if it exists).
+     * @param pagesPerStep Pages copied per step; smaller values yield more often.
+     * @param onProgress Optional callback, called after every step.
+     * @throws std::runtime_error if the backup fails, or if it makes no
+     * progress for five seconds because other connections keep the database
+     * locked or keep writing to it.
+     */
+    void backupTo(const std::string& destPath, int pagesPerStep = 64,
+                  BackupProgressCallback onProgress = nullptr);
+
+    /// Result of a maintain() pass.
+    struct MaintenanceReport {
+        std::int64_t bytesReclaimed = 0;   ///< Bytes returned to the OS by incremental vacuum.
+        std::int64_t reclaimableBytes = 0; ///< Free bytes left in the file when incremental vacuum is not enabled.
+        double elapsedSeconds = 0.0;       ///< Wall time spent in this pass.
+        bool analyzed = false;             ///< True if ANALYZE / PRAGMA optimize ran.
+        int indexesRebuilt = 0;            ///< Indexes rebuilt (REINDEX) in this pass.
+        bool complete = false;             ///< False if the budget ran out with work left.
+    };
+
+    /**
+     * @brief Runs one time-bounded maintenance pass on the dictionary.
+     *
+     * Refreshes query planner statistics (ANALYZE, PRAGMA optimize), computes
+     * the search and sort keys of rows that lack them (rows from an older
+     * dictionary that opening it did not get through, or from other tools),
+     * releases free pages in small incremental-vacuum slices until the budget is spent,
+     * and, if at least half the budget is left, rebuilds one index (a
+     * different one on each call). Runs on a private connection and gives up
+     * instead of waiting if another writer holds the database.
+     * @param budget Time to spend on vacuum slices; ANALYZE and one index
+     * rebuild may run past it on very large dictionaries.
+     * @return What the pass did and how long it took.
+     */
+    MaintenanceReport maintain(std::chrono::milliseconds budget = std::chrono::milliseconds(50));
+
+    /**
+     * @brief Switches an existing dictionary to auto_vacuum=INCREMENTAL so
+     * maintain() can shrink the file. New dictionaries are created this way.
+     * Runs a full VACUUM once, which blocks for the duration.
+     */
+    void enableIncrementalVacuum();
+
+    /**
+     * @brief Starts a background scheduler that calls maintain(budget) whenever
+     * the dictionary has been idle for `idleDelay`, and again only after new writes
+     * or while work is left over.
+     */
+    void startIdleMaintenance(std::chrono::milliseconds idleDelay = std::chrono::seconds(30),
+                              std::chrono::milliseconds budget = std::chrono::milliseconds(50));
+
+    /** @brief Stops the idle-time maintenance scheduler, if running. */
+    void stopIdleMaintenance();
+
+    /// Called when another connection or process has changed the dictionary.
+    using ChangeCallback = std::function<void()>;
+
+    /**
+     * @brief Registers a callback for external changes to the dictionary, e.g.
+     * to invalidate a suggestion cache.
+     *
+     * A change is external if it was committed by anything other than this
+     * manager's own calls: another process such as lekhika-cli, or this
+     * manager's background jobs (learnFromFileAsync, maintain). Callbacks
+     * run on the thread that detects the change.
+     * @return An id for removeChangeListener().
+     */
+    int addChangeListener(ChangeCallback callback);
+
+    /** @brief Unregisters a callback added with addChangeListener(). */
+    void removeChangeListener(int id);
+
+    /**
+     * @brief Checks for external changes now and notifies listeners if there were any.
+     *
+     * Costs one PRAGMA data_version query (no disk reads when nothing changed).
+     * @return True if the dictionary changed externally since the last check.
+     */
+    bool pollExternalChanges();
+
+    /**
+     * @brief Starts a background thread that calls pollExternalChanges() every `interval`.
+     */
+    void startChangeWatch(std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+
+    /** @brief Stops the background change watch, if running. */
+    void stopChangeWatch();
+
+    /// What revalidate() does with words that fail isValidDevanagariWord().
+    enum RepairAction {
+        RepairReportOnly = 0, ///< Only report offenders.
+        RepairDelete = 1,     ///< Delete offenders.
+        RepairNormalize = 2   ///< Strip punctuation and NFC-normalize offenders; merge the
+                              ///< result into the dictionary if valid, otherwise delete.
+    };
+
+    /// Result of a revalidate() run.
+    struct RevalidationReport {
+        long wordsScanned = 0;
+        long invalidFound = 0;
+        long deleted = 0;
+        long normalized = 0;                      ///< Offenders merged into their normalized form.
+        double elapsedSeconds = 0.0;
+        std::vector<std::string> sampleOffenders; ///< Up to the first 100 invalid words found.
+    };
+
+    /**
+     * @brief Re-checks every dictionary word against the current validation rules.
+     *
+     * Streams the dictionary in chunks, validates each chunk on `threads`
+     * worker threads, and applies the repairs for a chunk in one transaction.
+     * @param action What to do with invalid words; by default they are only reported.
+     * @param threads Number of validation threads (0 for one per CPU).
+     * @return Counts of scanned, invalid, deleted and normalized words.
+     * @throws std::runtime_error on a database error; the failing chunk's
+     * repairs are rolled back.
+     */
+    RevalidationReport revalidate(RepairAction action = RepairReportOnly, int threads = 0);
+
+    /**
+     * @brief Remembers the Devanagari output the user chose for a Roman input.
+     *
+     * Stored in the dictionary database and mirrored in an in-memory hash
+     * table. A Transliteration connected with setSelectionMemory() returns
+     * this output for the same input before applying any rules.
+     * @param roman The Roman input word, exactly as typed.
+     * @param devanagari The output the user selected.
+     * @throws std::runtime_error if the database write fails; the in-memory
+     * table is then left unchanged.
+     */
+    void recordSelection(const std::string& roman, const std::string& devanagari);
+
+    /**
+     * @brief Looks up a remembered selection in O(1).
+     *
+     * Only the first lookup reads the database, to load the in-memory table;
+     * a change watch (see startChangeWatch()) reloads it when another
+     * process changes it.
+     * @param roman The Roman input word.
+     * @param devanagari Receives the remembered output if found.
+     * @return True if a selection was remembered for `roman`.
+     */
+    bool lookupSelection(const std::string& roman, std::string& devanagari) const;
+
+    /**
+     * @brief Forgets the remembered selection for a Roman input.
+     * @throws std::runtime_error if the database write fails.
+     */
+    void forgetSelection(const std::string& roman);
+
     /// Defines the columns available for sorting database queries.
     enum SortColumn { ByWord = 0, ByFrequency = 1 };
 
     /**
      * @brief Retrieves all words from the dictionary with pagination and sorting.
+     *
+     * ByWord uses Nepali dictionary order from stored ICU collation keys. It
+     * falls back to code point order when ICU has no collation data, and
+     * while a dictionary from an older version still has rows without keys
+     * (see maintain()).
      * @param limit The maximum number of words per page (-1 for all).
      * @param offset The starting position for the query (for pagination).
      * @param sortBy The column to sort by (ByWord or ByFrequency).
@@ -172,6 +616,81 @@ public:
     /** @brief Rolls back the current database transaction. */
     void rollbackTransaction();
 
+    /**
+     * @brief Reports the memory held by this object.
+     *
+     * Entries: "selections.table" and "selections.strings" (remembered
+     * selections, once loaded), "segmenter.index" (segmentation trie, once
+     * built), "stats", "object", and this connection's SQLite memory:
+     * "sqlite.pageCache" (SQLITE_DBSTATUS_CACHE_USED), "sqlite.schema" and
+     * "sqlite.statements". Structures not yet loaded are left out rather
+     * than loaded for the report.
+     */
+    MemoryUsage memoryUsage() const;
+
+    /// Latency distribution with power-of-two microsecond buckets.
+    struct LatencyHistogram {
+        static constexpr int kBuckets = 24;
+        /// buckets[0] counts calls under 2 us; buckets[i] those in [2^i, 2^(i+1)) us.
+        /// The last bucket also holds everything slower.
+        std::uint64_t buckets[kBuckets] = {};
+        std::uint64_t count = 0;
+        std::uint64_t totalNanoseconds = 0;
+        std::uint64_t maxNanoseconds = 0;
+
+        /**
+         * @brief Estimates a latency quantile from the bucket bounds.
+         * @param q Quantile in [0, 1], e.g. 0.99.
+         * @return Upper bound of the bucket holding the quantile, capped at the maximum, in microseconds.
+         */
+        double percentileMicros(double q) const;
+    };
+
+    /// Counters for one public method, gathered while stats are enabled.
+    struct MethodStats {
+        LatencyHistogram latency;
+        std::uint64_t statements = 0;    ///< SQL statements the method ran.
+        std::uint64_t vmSteps = 0;       ///< Virtual machine steps (SQLITE_STMTSTATUS_VM_STEP).
+        std::uint64_t fullScanSteps = 0; ///< Table scan steps without an index (SQLITE_STMTSTATUS_FULLSCAN_STEP).
+        std::uint64_t sorts = 0;         ///< Sorts no index could satisfy (SQLITE_STMTSTATUS_SORT).
+        std::uint64_t autoIndexRows = 0; ///< Rows put in automatic indexes (SQLITE_STMTSTATUS_AUTOINDEX).
+    };
+
+    /// Snapshot returned by getStats().
+    struct Stats {
+        /// Keyed by method name ("findWords", "addWord", ...); only methods that ran are listed.
+        std::map<std::string, MethodStats> methods;
+        std::int64_t cacheHits = 0;      ///< Page cache hits (SQLITE_DBSTATUS_CACHE_HIT).
+        std::int64_t cacheMisses = 0;    ///< Pages read from the file (SQLITE_DBSTATUS_CACHE_MISS).
+        std::int64_t cacheWrites = 0;    ///< Pages written to the file (SQLITE_DBSTATUS_CACHE_WRITE).
+        std::int64_t cacheSpills = 0;    ///< Dirty pages spilled mid-transaction (SQLITE_DBSTATUS_CACHE_SPILL).
+        std::int64_t cacheUsedBytes = 0; ///< Page cache memory in use now (SQLITE_DBSTATUS_CACHE_USED).
+    };
+
+    /**
+     * @brief Enables/disables per-method latency histograms and statement
+     * counters (off by default).
+     *
+     * Covers the word query and update methods (findWords, addWord,
+     * searchWords, getWordFrequency, ...) on this object's connection;
+     * background jobs on their own connections are not counted. While
+     * disabled, each method pays one relaxed atomic load. Builds configured
+     * with LEKHIKA_STATS=OFF leave the method counters empty.
+     */
+    void setEnableStats(bool enable);
+
+    /**
+     * @brief Returns the counters gathered since the last resetStats().
+     *
+     * The page cache counters come from sqlite3_db_status() and are kept even
+     * while stats are disabled; a high miss share points at cache thrashing,
+     * and rising fullScanSteps or sorts for a method at a query plan regression.
+     */
+    Stats getStats() const;
+
+    /** @brief Clears the method counters and restarts the page cache counters from zero. */
+    void resetStats();
+
     /** * @brief Sets the maximum number of suggestions to return.
      * @param limit The new suggestion limit.
      */
@@ -221,6 +740,14 @@ public:
      */
     std::string transliterate(const std::string &input);
 
+    /**
+     * @brief Applies the smart-correction rules to one Roman word, as
+     * transliterate() does before mapping (e.g., pani -> panee).
+     * @param word A single Latin-script word.
+     * @return The corrected Roman word.
+     */
+    std::string applySmartCorrection(const std::string &word) const;
+
     /** @brief Enables/disables smart corrections (e.g., pani -> panee). */
     void setEnableSmartCorrection(bool enable);
     /** @brief Enables/disables auto-correction of specific words from a list. */
@@ -230,6 +757,103 @@ public:
     /** @brief Enables/disables transliteration of common symbols (e.g., ? -> ।). */
     void setEnableSymbolsTransliteration(bool enable);
 
+    /// Pipeline stages of transliterate() that are timed when stats are enabled.
+    enum Stage {
+        StagePreprocessInput, ///< Spacing before punctuation and symbols.
+        StageMaskBraces,      ///< Replacing {verbatim} spans with placeholders.
+        StageAutoCorrect,     ///< Lookup in the auto-correct word list.
+        StageSmartCorrection, ///< Smart-correction rewrite rules.
+        StageSegment,         ///< Longest-match mapping of each word.
+        StageRestoreBraces,   ///< Putting {verbatim} spans back.
+        StageCount
+    };
+
+    /// Per-stage counters for one stage of the pipeline.
+    struct StageStats {
+        std::uint64_t calls = 0;       ///< Times the stage ran.
+        std::uint64_t nanoseconds = 0; ///< Wall time spent in the stage.
+        std::uint64_t bytes = 0;       ///< Input bytes the stage processed.
+    };
+
+    /// Snapshot of the instrumentation counters (see setEnableStats()).
+    struct Stats {
+        std::uint64_t calls = 0;            ///< transliterate() calls.
+        std::uint64_t inputBytes = 0;       ///< Bytes passed to transliterate().
+        std::uint64_t outputBytes = 0;      ///< Bytes returned by transliterate().
+        std::uint64_t words = 0;            ///< Space-separated words handled.
+        std::uint64_t mapLookups = 0;       ///< Probes of the mapping table.
+        std::uint64_t mapHits = 0;          ///< Probes that found a mapping.
+        std::uint64_t autoCorrectHits = 0;  ///< Words replaced from the auto-correct list.
+        std::uint64_t selectionHits = 0;    ///< Words answered from selection memory.
+        StageStats stages[StageCount];      ///< Indexed by Stage.
+
+        /** @brief Short name of a stage, e.g. "segment". */
+        static const char* stageName(Stage stage);
+    };
+
+    /**
+     * @brief Enables/disables the instrumentation counters (off by default).
+     *
+     * While disabled, each counter site costs one predictable branch and no
+     * clock reads. Builds configured with LEKHIKA_STATS=OFF compile the
+     * counters out entirely; getStats() then always returns zeros.
+     */
+    void setEnableStats(bool enable);
+    /** @brief Returns a copy of the counters gathered since the last reset. */
+    Stats getStats() const;
+    /** @brief Sets all counters back to zero. */
+    void resetStats();
+
+    /// Hit counts gathered in profiling mode (see setEnableProfiling()).
+    struct Profile {
+        /// Every mapping key -> times it matched; unused keys have 0.
+        std::map<std::string, std::uint64_t> mappingHits;
+        /// Every auto-correct word -> times it replaced a word; unused words have 0.
+        std::map<std::string, std::uint64_t> autoCorrectHits;
+        /// Every smart-correction rule (e.g. "final-i-to-ee") -> times it rewrote a word.
+        std::map<std::string, std::uint64_t> ruleHits;
+        /// Every code path a word or character can take (e.g. "word.single-char",
+        /// "segment.unmapped-byte") -> times it was taken.
+        std::map<std::string, std::uint64_t> pathHits;
+    };
+
+    /**
+     * @brief Enables/disables per-key and per-rule hit counting (off by default).
+     *
+     * Meant for corpus runs that find hot and dead mapping entries; it slows
+     * transliteration down while on. While off, each counting site costs one
+     * branch. Compiled out with LEKHIKA_STATS=OFF.
+     */
+    void setEnableProfiling(bool enable);
+    /**
+     * @brief Returns whether hit counting is on. Always false in builds
+     * configured with LEKHIKA_STATS=OFF, where getProfile() reports no hits.
+     */
+    bool isProfilingEnabled() const;
+    /** @brief Returns the hit counts gathered since the last reset. */
+    Profile getProfile() const;
+    /** @brief Sets all hit counts back to zero. */
+    void resetProfile();
+
+    /**
+     * @brief Reports the memory held by this object.
+     *
+     * Entries: "charMap.table" and "charMap.strings" (mapping rules),
+     * "specialWords.table" and "specialWords.strings" (auto-correct list),
+     * and "object" (the engine state itself).
+     */
+    MemoryUsage memoryUsage() const;
+
+#ifdef HAVE_SQLITE3
+    /**
+     * @brief Consults the user's remembered selections (see
+     * DictionaryManager::recordSelection) before the rules, word by word.
+     * @param dict The dictionary holding the selections, or nullptr to stop
+     * consulting it. Must outlive this object or be detached first.
+     */
+    void setSelectionMemory(const DictionaryManager* dict);
+#endif
+
 private:
     class Impl;
     std::unique_ptr<Impl> pImpl;
@@ -0,0 +1,309 @@
+/********************************************************************
+ * lekhika_c.cpp  –  lekhika C API implementation.
+ ********************************************************************
+Copyright (C) <2025> <Khumnath Cg/nath.khum@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>
+ *******************************************************************/
+#include "liblekhika/lekhika_c.h"
+
+// ICU first, so that lekhika_core.h's forward declaration names ICU's
+// versioned namespace and the UnicodeString overloads below resolve.
+#include <unicode/bytestream.h>
+#include <unicode/unistr.h>
+
+#include "liblekhika/lekhika_core.h"
+
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+struct lekhika_transliterator {
+    explicit lekhika_transliterator(const std::string& dataDir) : engine(dataDir) {}
+
+    Transliteration engine;
+    // Reused across calls so steady-state calls do not grow the heap. After
+    // LEKHIKA_ERR_BUFFER_TOO_SMALL, the next call with the same input returns
+    // lastOutput instead of transliterating again; no other call is served
+    // from it, so every transliteration is seen by stats, tracing and profiling.
+    std::string lastInput;
+    std::string lastOutput;
+    bool retryPending = false;
+};
+
+#ifdef HAVE_SQLITE3
+struct lekhika_dictionary {
+    explicit lekhika_dictionary(const std::string& path) : manager(path) {}
+
+    DictionaryManager manager;
+    std::string scratch;
+};
+#else
+struct lekhika_dictionary {};
+#endif
+
+namespace {
+
+thread_local std::string lastError;
+
+lekhika_status fail(lekhika_status status, const char* message) {
+    lastError = message;
+    return status;
+}
+
+// Maps an in-flight exception to a status; used in every catch (...).
+lekhika_status failCurrent() {
+    try {
+        throw;
+    } catch (const std::bad_alloc&) {
+        return fail(LEKHIKA_ERR_FAILED, "out of memory");
+    } catch (const std::exception& e) {
+        return fail(LEKHIKA_ERR_FAILED, e.what());
+    } catch (...) {
+        return fail(LEKHIKA_ERR_FAILED, "unknown error");
+    }
+}
+
+icu::UnicodeString fromUtf8(const char* data, size_t len) {
+    return icu::UnicodeString::fromUTF8(icu::StringPiece(data, static_cast<int32_t>(len)));
+}
+
+// Copies `len` bytes of result into the caller's buffer, per the header's
+// buffer convention.
+lekhika_status writeOut(const char* data, size_t len, char* out, size_t outCap, size_t* outLen) {
+    *outLen = len;
+    if (outCap < len || (len > 0 && !out)) {
+        return fail(LEKHIKA_ERR_BUFFER_TOO_SMALL, "output buffer too small");
+    }
+    if (len > 0) std::memcpy(out, data, len);
+    if (outCap > len) out[len] = '\0';
+    return LEKHIKA_OK;
+}
+
+bool badInput(const char* data, size_t len) {
+    return !data && len > 0;
+}
+
+} // namespace
+
+extern "C" {
+
+const char* lekhika_version(void) {
+    return LEKHIKA_VERSION;
+}
+
+const char* lekhika_last_error(void) {
+    return lastError.c_str();
+}
+
+int lekhika_is_valid_word(const char* word, size_t len) {
+    if (badInput(word, len)) return 0;
+    try {
+        return isValidDevanagariWord(fromUtf8(word, len)) ? 1 : 0;
+    } catch (...) {
+        failCurrent();
+        return 0;
+    }
+}
+
+lekhika_status lekhika_sanitize_word(const char* word, size_t len, char* out, size_t out_cap, size_t* out_len) {
+    if (badInput(word, len) || !out_len) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    try {
+        icu::UnicodeString sanitized = sanitizeDevanagariWord(fromUtf8(word, len));
+        // Encode straight into the caller's buffer; the sink still counts the
+        // full length when it overflows.
+        icu::CheckedArrayByteSink sink(out, static_cast<int32_t>(out ? out_cap : 0));
+        sanitized.toUTF8(sink);
+        *out_len = static_cast<size_t>(sink.NumberOfBytesAppended());
+        if (sink.Overflowed()) return fail(LEKHIKA_ERR_BUFFER_TOO_SMALL, "output buffer too small");
+        if (out_cap > *out_len) out[*out_len] = '\0';
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+lekhika_status lekhika_transliterator_new(const char* data_dir, size_t data_dir_len, lekhika_transliterator** out) {
+    if (badInput(data_dir, data_dir_len) || !out) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    *out = nullptr;
+    try {
+        *out = new lekhika_transliterator(data_dir ? std::string(data_dir, data_dir_len) : std::string());
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+void lekhika_transliterator_free(lekhika_transliterator* t) {
+    delete t;
+}
+
+lekhika_status lekhika_transliterator_set_option(lekhika_transliterator* t, lekhika_option option, int enabled) {
+    if (!t) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null handle");
+    switch (option) {
+    case LEKHIKA_OPTION_SMART_CORRECTION: t->engine.setEnableSmartCorrection(enabled != 0); break;
+    case LEKHIKA_OPTION_AUTOCORRECT: t->engine.setEnableAutoCorrect(enabled != 0); break;
+    case LEKHIKA_OPTION_INDIC_NUMBERS: t->engine.setEnableIndicNumbers(enabled != 0); break;
+    case LEKHIKA_OPTION_SYMBOLS: t->engine.setEnableSymbolsTransliteration(enabled != 0); break;
+    default: return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "unknown option");
+    }
+    t->retryPending = false;
+    return LEKHIKA_OK;
+}
+
+lekhika_status lekhika_transliterate(lekhika_transliterator* t, const char* input, size_t input_len,
+                                     char* out, size_t out_cap, size_t* out_len) {
+    if (!t || badInput(input, input_len) || !out_len) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    try {
+        bool retry = t->retryPending && t->lastInput.size() == input_len &&
+                     (input_len == 0 || std::memcmp(t->lastInput.data(), input, input_len) == 0);
+        t->retryPending = false;
+        if (!retry) {
+            t->lastInput.assign(input, input_len);
+            t->lastOutput = t->engine.transliterate(t->lastInput);
+        }
+        lekhika_status status = writeOut(t->lastOutput.data(), t->lastOutput.size(), out, out_cap, out_len);
+        t->retryPending = status == LEKHIKA_ERR_BUFFER_TOO_SMALL;
+        return status;
+    } catch (...) {
+        t->retryPending = false;
+        return failCurrent();
+    }
+}
+
+lekhika_status lekhika_transliterator_set_selection_memory(lekhika_transliterator* t, const lekhika_dictionary* d) {
+    if (!t) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null handle");
+#ifdef HAVE_SQLITE3
+    t->engine.setSelectionMemory(d ? &d->manager : nullptr);
+    t->retryPending = false;
+    return LEKHIKA_OK;
+#else
+    (void)d;
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+#endif
+}
+
+#ifdef HAVE_SQLITE3
+
+lekhika_status lekhika_dictionary_open(const char* path, size_t path_len, lekhika_dictionary** out) {
+    if (badInput(path, path_len) || !out) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    *out = nullptr;
+    try {
+        *out = new lekhika_dictionary(path ? std::string(path, path_len) : std::string());
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+void lekhika_dictionary_free(lekhika_dictionary* d) {
+    delete d;
+}
+
+lekhika_status lekhika_dictionary_add_word(lekhika_dictionary* d, const char* word, size_t len) {
+    if (!d || badInput(word, len)) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    try {
+        d->scratch.assign(word, len);
+        d->manager.addWord(d->scratch);
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+lekhika_status lekhika_dictionary_remove_word(lekhika_dictionary* d, const char* word, size_t len) {
+    if (!d || badInput(word, len)) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    try {
+        d->scratch.assign(word, len);
+        d->manager.removeWord(d->scratch);
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+lekhika_status lekhika_dictionary_word_frequency(lekhika_dictionary* d, const char* word, size_t len, int* frequency) {
+    if (!d || badInput(word, len) || !frequency) return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    try {
+        d->scratch.assign(word, len);
+        *frequency = d->manager.getWordFrequency(d->scratch);
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+lekhika_status lekhika_dictionary_find_words(lekhika_dictionary* d, const char* prefix, size_t prefix_len, int limit,
+                                             char* out, size_t out_cap, size_t* out_len, size_t* count) {
+    if (!d || badInput(prefix, prefix_len) || !out_len || !count) {
+        return fail(LEKHIKA_ERR_INVALID_ARGUMENT, "null argument");
+    }
+    try {
+        d->scratch.assign(prefix, prefix_len);
+        std::vector<std::string> words = d->manager.findWords(d->scratch, limit);
+        size_t needed = 0;
+        for (const auto& word : words) needed += word.size() + 1;
+        *out_len = needed;
+        *count = words.size();
+        if (out_cap < needed || (needed > 0 && !out)) {
+            return fail(LEKHIKA_ERR_BUFFER_TOO_SMALL, "output buffer too small");
+        }
+        char* p = out;
+        for (const auto& word : words) {
+            std::memcpy(p, word.data(), word.size());
+            p += word.size();
+            *p++ = '\0';
+        }
+        return LEKHIKA_OK;
+    } catch (...) {
+        return failCurrent();
+    }
+}
+
+#else // !HAVE_SQLITE3
+
+// The dictionary entry points stay exported so the ABI does not depend on
+// how the library was configured.
+lekhika_status lekhika_dictionary_open(const char*, size_t, lekhika_dictionary** out) {
+    if (out) *out = nullptr;
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+}
+
+void lekhika_dictionary_free(lekhika_dictionary* d) {
+    delete d;
+}
+
+lekhika_status lekhika_dictionary_add_word(lekhika_dictionary*, const char*, size_t) {
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+}
+
+lekhika_status lekhika_dictionary_remove_word(lekhika_dictionary*, const char*, size_t) {
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+}
+
+lekhika_status lekhika_dictionary_word_frequency(lekhika_dictionary*, const char*, size_t, int*) {
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+}
+
+lekhika_status lekhika_dictionary_find_words(lekhika_dictionary*, const char*, size_t, int,
+                                             char*, size_t, size_t*, size_t*) {
+    return fail(LEKHIKA_ERR_UNSUPPORTED, "built without dictionary support");
+}
+
+#endif // HAVE_SQLITE3
+
+} // extern "C"
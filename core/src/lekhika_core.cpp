@@ -21,10 +21,23 @@ along with this program. If not, see <https://www.gnu.org/licenses/>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <stdexcept>
 #include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <optional>
 
 // ICU includes for Unicode string handling and validation
 #include <unicode/unistr.h>
@@ -32,13 +45,130 @@ along with this program. If not, see <https://www.gnu.org/licenses/>
 #include <unicode/locid.h>
 #include <unicode/utypes.h>
 #include <unicode/uchar.h>
+#include <unicode/coll.h>
+#include <unicode/normalizer2.h>
 
 #ifdef HAVE_SQLITE3
 #include <sqlite3.h>
 #endif
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define LEKHIKA_X86_DISPATCH 1
+#endif
+
 namespace fs = std::filesystem;
 
+// =============================================================================//
+// CPU dispatch
+// =============================================================================//
+// Byte-class scans for the validation and transliteration hot paths. The
+// library is built for baseline x86-64, so the SSE2, AVX2 and AVX-512 kernels
+// are compiled with per-function target attributes and the best one the CPU
+// supports is picked on first use. LEKHIKA_SIMD=scalar|sse2|avx2|avx512 forces
+// a lower level, so every kernel can be exercised on one machine.
+namespace {
+
+enum SimdLevel { SimdScalar, SimdSse2, SimdAvx2, SimdAvx512, SimdLevelCount };
+const char* const kSimdLevelNames[SimdLevelCount] = {"scalar", "sse2", "avx2", "avx512"};
+
+// Each kernel returns the offset of the first byte with the high bit set
+// (NonAscii) or clear, starting at `i`, or `n` if there is none.
+template <bool NonAscii>
+size_t scanScalar(const unsigned char* s, size_t n, size_t i) {
+    for (; i < n; ++i) {
+        if ((s[i] >= 0x80) == NonAscii) return i;
+    }
+    return n;
+}
+
+template <bool NonAscii>
+size_t scanScalar(const unsigned char* s, size_t n) { return scanScalar<NonAscii>(s, n, 0); }
+
+#ifdef LEKHIKA_X86_DISPATCH
+template <bool NonAscii>
+__attribute__((target("sse2"))) size_t scanSse2(const unsigned char* s, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        unsigned high = static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))));
+        unsigned hits = NonAscii ? high : ~high & 0xFFFFu;
+        if (hits) return i + __builtin_ctz(hits);
+    }
+    return scanScalar<NonAscii>(s, n, i);
+}
+
+template <bool NonAscii>
+__attribute__((target("avx2"))) size_t scanAvx2(const unsigned char* s, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned high = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i))));
+        unsigned hits = NonAscii ? high : ~high;
+        if (hits) return i + __builtin_ctz(hits);
+    }
+    return scanScalar<NonAscii>(s, n, i);
+}
+
+// Masked loads handle the tail without reading past the end of the string.
+template <bool NonAscii>
+__attribute__((target("avx512f,avx512bw"))) size_t scanAvx512(const unsigned char* s, size_t n) {
+    for (size_t i = 0; i < n; i += 64) {
+        __mmask64 live = n - i >= 64 ? ~0ull : (1ull << (n - i)) - 1;
+        __mmask64 high = _mm512_movepi8_mask(_mm512_maskz_loadu_epi8(live, s + i));
+        __mmask64 hits = (NonAscii ? high : ~high) & live;
+        if (hits) return i + __builtin_ctzll(hits);
+    }
+    return n;
+}
+#endif
+
+struct ScanKernels {
+    SimdLevel level;
+    size_t (*findAscii)(const unsigned char*, size_t);
+    size_t (*findNonAscii)(const unsigned char*, size_t);
+};
+
+SimdLevel detectSimdLevel() {
+#ifdef LEKHIKA_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return SimdAvx512;
+    if (__builtin_cpu_supports("avx2")) return SimdAvx2;
+    if (__builtin_cpu_supports("sse2")) return SimdSse2;
+#endif
+    return SimdScalar;
+}
+
+const ScanKernels& scanKernels() {
+    static const ScanKernels kernels = [] {
+        SimdLevel level = detectSimdLevel();
+        if (const char* forced = std::getenv("LEKHIKA_SIMD")) {
+            for (int l = 0; l < SimdLevelCount; ++l) {
+                if (std::strcmp(forced, kSimdLevelNames[l]) == 0) level = std::min(level, static_cast<SimdLevel>(l));
+            }
+        }
+        switch (level) {
+#ifdef LEKHIKA_X86_DISPATCH
+        case SimdAvx512: return ScanKernels{level, scanAvx512<false>, scanAvx512<true>};
+        case SimdAvx2: return ScanKernels{level, scanAvx2<false>, scanAvx2<true>};
+        case SimdSse2: return ScanKernels{level, scanSse2<false>, scanSse2<true>};
+#endif
+        default: return ScanKernels{SimdScalar, scanScalar<false>, scanScalar<true>};
+        }
+    }();
+    return kernels;
+}
+
+// Offset of the first ASCII byte, or `n` if there is none.
+inline size_t findAsciiByte(const char* s, size_t n) {
+    return scanKernels().findAscii(reinterpret_cast<const unsigned char*>(s), n);
+}
+
+// Offset of the first non-ASCII byte, or `n` if there is none.
+inline size_t findNonAsciiByte(const char* s, size_t n) {
+    return scanKernels().findNonAscii(reinterpret_cast<const unsigned char*>(s), n);
+}
+
+} // namespace
+
 // =============================================================================//
 // Standalone Function Implementations
 // =============================================================================//
@@ -48,6 +178,10 @@ std::string getLekhikaVersion() {
     return LEKHIKA_VERSION;
 }
 
+std::string getSimdLevel() {
+    return kSimdLevelNames[scanKernels().level];
+}
+
 // ----------------- Character classification -----------------
 inline bool isDevanagariConsonant(UChar32 c) {
     // Standard consonants and extended consonants
@@ -92,10 +226,15 @@ inline bool isAllowedDevanagariChar(UChar32 c) {
 //rejects single-grapheme tokens as they are not considered valid dictionary words in this system
 int graphemeCount(const icu::UnicodeString &u) {
     if (u.isEmpty()) return 0;
-    UErrorCode status = U_ZERO_ERROR;
-    std::unique_ptr<icu::BreakIterator> it(
-        icu::BreakIterator::createCharacterInstance(icu::Locale::getDefault(), status));
-    if (U_FAILURE(status)) return u.length(); // Fallback
+    // Creating a break iterator costs far more than using one, so keep one per thread.
+    thread_local std::unique_ptr<icu::BreakIterator> it = []() {
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> bi(
+            icu::BreakIterator::createCharacterInstance(icu::Locale::getDefault(), status));
+        if (U_FAILURE(status)) bi.reset();
+        return bi;
+    }();
+    if (!it) return u.length(); // Fallback
     it->setText(u);
 
     int count = 0;
@@ -243,16 +382,504 @@ bool isValidDevanagariWord(const icu::UnicodeString &u) {
 
 // ----------------- Overload for std::string -----------------
 bool isValidDevanagariWord(const std::string &s) {
+    // ASCII is never part of a valid word; rejecting mixed-script tokens on a
+    // byte scan skips the UTF-16 conversion and grapheme segmentation.
+    if (findAsciiByte(s.data(), s.size()) != s.size()) return false;
     return isValidDevanagariWord(icu::UnicodeString::fromUTF8(s));
 }
 
+// =============================================================================//
+// Tracing
+// =============================================================================//
+namespace {
+std::atomic<TraceSink*> g_traceSink{nullptr};
+}
+
+void setTraceSink(TraceSink* sink) { g_traceSink.store(sink, std::memory_order_release); }
+TraceSink* getTraceSink() { return g_traceSink.load(std::memory_order_acquire); }
+
+// Reports a span to the installed sink for its lifetime. Attribute builders
+// only run when a sink is installed, so an untraced span is one branch.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : sink_(getTraceSink()), name_(name) {
+        if (sink_) sink_->beginSpan(name_, {});
+    }
+    template <typename Builder>
+    TraceSpan(const char* name, Builder&& attributes) : sink_(getTraceSink()), name_(name) {
+        if (sink_) sink_->beginSpan(name_, attributes());
+    }
+    ~TraceSpan() {
+        if (sink_) sink_->endSpan(name_, endAttributes_);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // True when traced; guard addEndAttribute() calls with it.
+    explicit operator bool() const { return sink_ != nullptr; }
+    void addEndAttribute(const char* key, std::string value) {
+        endAttributes_.push_back({key, std::move(value)});
+    }
+
+private:
+    TraceSink* sink_;
+    const char* name_;
+    TraceAttributes endAttributes_;
+};
+
+class ChromeTraceSink::Impl {
+public:
+    std::mutex mutex_;
+    std::ofstream out_;
+    bool first_ = true;
+    const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+    // Small sequential ids read better in trace viewers than hashed thread ids.
+    static int threadId() {
+        static std::atomic<int> next{1};
+        thread_local int id = next++;
+        return id;
+    }
+
+    static void appendJsonString(std::string& out, const char* s) {
+        out += '"';
+        for (; *s; ++s) {
+            unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else if (c < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+        out += '"';
+    }
+
+    void write(const char* phase, const char* name, const TraceAttributes& attributes) {
+        double ts = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+        std::string event = "{\"name\": ";
+        appendJsonString(event, name);
+        char fields[96];
+        std::snprintf(fields, sizeof(fields), ", \"ph\": \"%s\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d",
+                      phase, ts, threadId());
+        event += fields;
+        if (!attributes.empty()) {
+            event += ", \"args\": {";
+            for (size_t i = 0; i < attributes.size(); ++i) {
+                if (i) event += ", ";
+                appendJsonString(event, attributes[i].key);
+                event += ": ";
+                appendJsonString(event, attributes[i].value.c_str());
+            }
+            event += '}';
+        }
+        event += '}';
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << (first_ ? "[\n" : ",\n") << event;
+        first_ = false;
+    }
+};
+
+ChromeTraceSink::ChromeTraceSink(const std::string& path) : pImpl(std::make_unique<Impl>()) {
+    pImpl->out_.open(path, std::ios::trunc);
+    if (!pImpl->out_) {
+        throw std::runtime_error("Cannot create trace file: " + path);
+    }
+}
+
+ChromeTraceSink::~ChromeTraceSink() {
+    TraceSink* self = this;
+    g_traceSink.compare_exchange_strong(self, nullptr);
+    std::lock_guard<std::mutex> lock(pImpl->mutex_);
+    pImpl->out_ << (pImpl->first_ ? "[\n]\n" : "\n]\n");
+}
+
+void ChromeTraceSink::beginSpan(const char* name, const TraceAttributes& attributes) {
+    pImpl->write("B", name, attributes);
+}
+
+void ChromeTraceSink::endSpan(const char* name, const TraceAttributes& attributes) {
+    pImpl->write("E", name, attributes);
+}
+
+// =============================================================================//
+// Memory accounting
+// =============================================================================//
+std::size_t MemoryUsage::total() const {
+    std::size_t sum = 0;
+    for (const auto& [name, size] : bytes) sum += size;
+    return sum;
+}
+
+// Heap bytes of a string's payload; short strings live inside the object.
+static std::size_t stringHeapBytes(const std::string& s) {
+    static const std::size_t inlineCapacity = std::string().capacity();
+    return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0;
+}
+
+// Bucket array plus one node per element. Nodes follow the libstdc++ layout:
+// next pointer, the value and, for keys with non-trivial hashes, the cached hash.
+template <typename Map>
+static std::size_t hashTableBytes(const Map& map, bool cachedHash = true) {
+    std::size_t node = sizeof(void*) + sizeof(typename Map::value_type) + (cachedHash ? sizeof(std::size_t) : 0);
+    return map.bucket_count() * sizeof(void*) + map.size() * node;
+}
+
+template <typename Map>
+static std::size_t stringPayloadBytes(const Map& map) {
+    std::size_t bytes = 0;
+    for (const auto& [key, value] : map) bytes += stringHeapBytes(key) + stringHeapBytes(value);
+    return bytes;
+}
+
 #ifdef HAVE_SQLITE3
+// =============================================================================//
+// Compact key encoding
+// =============================================================================//
+// Internal one-byte-per-character encoding of words for index keys. UTF-8
+// spends three bytes on every Devanagari code point; here:
+//   0x80-0xFF  U+0900-U+097F (Devanagari block)
+//   0x01/0x02  ZWNJ/ZWJ
+//   0x03       escape, followed by the UTF-8 bytes of any other code point
+//   0x04-0x7F  ASCII as is (0x00-0x03 are escaped)
+// Each code point encodes independently, so the key of a prefix is a prefix
+// of the key of the word, which is what findWords() range scans rely on.
+static std::string compactKey(const char* utf8, size_t len) {
+    std::string key;
+    key.reserve(len / 2 + 1);
+    const auto* s = reinterpret_cast<const unsigned char*>(utf8);
+    for (size_t i = 0; i < len;) {
+        unsigned char b0 = s[i];
+        if (b0 == 0xE0 && i + 2 < len && (s[i + 1] == 0xA4 || s[i + 1] == 0xA5)) {
+            key += static_cast<char>(0x80 + ((s[i + 1] & 1) << 6) + (s[i + 2] & 0x3F));
+            i += 3;
+            continue;
+        }
+        if (b0 == 0xE2 && i + 2 < len && s[i + 1] == 0x80 && (s[i + 2] == 0x8C || s[i + 2] == 0x8D)) {
+            key += static_cast<char>(s[i + 2] == 0x8C ? 0x01 : 0x02);
+            i += 3;
+            continue;
+        }
+        if (b0 >= 0x04 && b0 < 0x80) {
+            key += static_cast<char>(b0);
+            i += 1;
+            continue;
+        }
+        size_t n = b0 < 0x80 ? 1 : b0 >= 0xF0 ? 4 : b0 >= 0xE0 ? 3 : b0 >= 0xC0 ? 2 : 1;
+        n = std::min(n, len - i);
+        key += '\x03';
+        key.append(utf8 + i, n);
+        i += n;
+    }
+    return key;
+}
+
+// =============================================================================//
+// Dictionary-based segmentation
+// =============================================================================//
+// Immutable UTF-16 trie over all dictionary words, scored by frequency.
+// Used to split unspaced Devanagari runs (OCR output, scraped text) into words.
+class SegmentationTrie {
+public:
+    explicit SegmentationTrie(sqlite3* db) {
+        nodeCost_.push_back(kInf); // root
+        sqlite3_stmt* stmt = nullptr;
+        double total = 0;
+        std::vector<std::pair<uint32_t, int>> terminals;
+        if (sqlite3_prepare_v2(db, "SELECT word, frequency FROM words;", -1, &stmt, nullptr) == SQLITE_OK) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                int freq = std::max(1, sqlite3_column_int(stmt, 1));
+                icu::UnicodeString w = icu::UnicodeString::fromUTF8(text);
+                uint32_t node = 0;
+                for (int32_t i = 0; i < w.length(); ++i) {
+                    uint64_t key = edgeKey(node, w.charAt(i));
+                    auto it = edges_.find(key);
+                    if (it == edges_.end()) {
+                        uint32_t child = static_cast<uint32_t>(nodeCost_.size());
+                        nodeCost_.push_back(kInf);
+                        edges_.emplace(key, child);
+                        node = child;
+                    } else {
+                        node = it->second;
+                    }
+                }
+                maxWordLength_ = std::max(maxWordLength_, w.length());
+                terminals.emplace_back(node, freq);
+                total += freq;
+            }
+            sqlite3_finalize(stmt);
+        }
+        // Unigram cost: -log(P(word)). Unknown graphemes cost more than any known word.
+        double logTotal = std::log(std::max(total, 1.0));
+        for (const auto& [node, freq] : terminals) {
+            nodeCost_[node] = logTotal - std::log(static_cast<double>(freq));
+        }
+        unknownCost_ = logTotal + 10.0;
+    }
+
+    bool empty() const { return edges_.empty(); }
+
+    std::size_t memoryBytes() const {
+        return sizeof(*this) + hashTableBytes(edges_, false) + nodeCost_.capacity() * sizeof(double);
+    }
+
+    // Viterbi search over grapheme boundaries. The trie walk from each position is
+    // bounded by the longest word, so this is linear in the input length.
+    // Adjacent graphemes not covered by any dictionary word are returned as one piece;
+    // `allKnown` is set to false if any such piece exists.
+    std::vector<std::string> segment(const icu::UnicodeString& text, bool* allKnown = nullptr) const {
+        std::vector<std::string> result;
+        if (allKnown) *allKnown = true;
+        const int32_t n = text.length();
+        if (n == 0) return result;
+
+        std::vector<char> isBoundary(n + 1, 0);
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> it(
+            icu::BreakIterator::createCharacterInstance(icu::Locale::getDefault(), status));
+        if (U_FAILURE(status)) {
+            std::fill(isBoundary.begin(), isBoundary.end(), 1);
+        } else {
+            it->setText(text);
+            for (int32_t p = it->first(); p != icu::BreakIterator::DONE; p = it->next()) {
+                isBoundary[p] = 1;
+            }
+        }
+
+        std::vector<double> best(n + 1, kInf);
+        std::vector<int32_t> back(n + 1, -1);
+        std::vector<char> known(n + 1, 0);
+        best[0] = 0;
+        for (int32_t i = 0; i < n; ++i) {
+            if (!isBoundary[i] || best[i] == kInf) continue;
+
+            // Fallback edge: a single unknown grapheme.
+            int32_t next = i + 1;
+            while (next < n && !isBoundary[next]) ++next;
+            if (best[i] + unknownCost_ < best[next]) {
+                best[next] = best[i] + unknownCost_;
+                back[next] = i;
+                known[next] = 0;
+            }
+
+            uint32_t node = 0;
+            const int32_t end = std::min(n, i + maxWordLength_);
+            for (int32_t j = i; j < end; ++j) {
+                auto e = edges_.find(edgeKey(node, text.charAt(j)));
+                if (e == edges_.end()) break;
+                node = e->second;
+                double cost = nodeCost_[node];
+                if (cost != kInf && isBoundary[j + 1] && best[i] + cost < best[j + 1]) {
+                    best[j + 1] = best[i] + cost;
+                    back[j + 1] = i;
+                    known[j + 1] = 1;
+                }
+            }
+        }
+
+        std::vector<std::pair<int32_t, int32_t>> spans;
+        for (int32_t pos = n; pos > 0; pos = back[pos]) {
+            int32_t start = back[pos];
+            // Merge runs of unknown graphemes into a single piece.
+            if (!known[pos] && allKnown) *allKnown = false;
+            if (!known[pos] && !spans.empty() && !known[spans.back().second]) {
+                spans.back().first = start;
+            } else {
+                spans.emplace_back(start, pos);
+            }
+        }
+        for (auto span = spans.rbegin(); span != spans.rend(); ++span) {
+            std::string piece;
+            text.tempSubStringBetween(span->first, span->second).toUTF8String(piece);
+            result.push_back(std::move(piece));
+        }
+        return result;
+    }
+
+private:
+    static constexpr double kInf = std::numeric_limits<double>::infinity();
+    static uint64_t edgeKey(uint32_t node, UChar c) { return (static_cast<uint64_t>(node) << 16) | c; }
+
+    std::unordered_map<uint64_t, uint32_t> edges_;
+    std::vector<double> nodeCost_;
+    int32_t maxWordLength_ = 0;
+    double unknownCost_ = 0;
+};
+
 // =============================================================================//
 // DictionaryManager Implementation (PImpl Idiom)
 // =============================================================================//
 class DictionaryManager::Impl {
 public:
     sqlite3* db_ = nullptr;
+    std::string dbPath_;
+
+    // Background learn job state
+    std::thread learnWorker_;
+    std::atomic<bool> learnRunning_{false};
+    std::atomic<bool> learnCancel_{false};
+
+    // Segmentation trie, rebuilt lazily after the word list changes. The
+    // pointer is swapped under segmenterMutex_; holders keep their snapshot.
+    std::mutex segmenterMutex_;
+    std::shared_ptr<const SegmentationTrie> segmenter_;
+    std::atomic<bool> segmenterDirty_{true};
+    bool segmentOnLearn_ = false;
+
+    // sort_key/word_key state. hasCollator_ is false on ICU builds without
+    // collation data, where sort keys stay NULL. keysComplete_ is false while
+    // rows from format 1.0 still wait for keys; until then ByWord orders by
+    // the word itself.
+    bool hasCollator_ = false;
+    std::atomic<bool> keysComplete_{false};
+
+    // Maintenance state. lastActivity_ is updated by a statement trace hook
+    // on db_ and drives the idle-time scheduler.
+    std::atomic<std::int64_t> lastActivity_{0};
+    std::mutex maintenanceMutex_;
+    size_t nextReindex_ = 0;
+    std::thread idleWorker_;
+    std::mutex idleMutex_;
+    std::condition_variable idleCv_;
+    bool idleStop_ = false;
+
+    // External change detection (PRAGMA data_version on db_)
+    std::mutex listenersMutex_;
+    std::map<int, ChangeCallback> changeListeners_;
+    int nextListenerId_ = 1;
+    std::atomic<std::int64_t> dataVersion_{-1};
+    std::thread watchWorker_;
+    std::mutex watchMutex_;
+    std::condition_variable watchCv_;
+    bool watchStop_ = false;
+
+    // Roman input -> the Devanagari output the user chose for it, mirrored
+    // from the selections table for O(1) lookups from transliterate(). Loaded
+    // on the first lookup, so managers that never transliterate skip it.
+    mutable std::shared_mutex selectionsMutex_;
+    std::unordered_map<std::string, std::string> selections_;
+    std::atomic<bool> selectionsLoaded_{false};
+
+    // Instrumented public methods; kMethodNames holds their names.
+    enum Method {
+        MethodFindWords, MethodSearchWords, MethodGetWordFrequency, MethodUpdateWordFrequency,
+        MethodAddWord, MethodRemoveWord, MethodGetAllWords, MethodSegmentWords, MethodLearnFromFile,
+        MethodImportWords, MethodExportWords, MethodMergeFrom, MethodRecordSelection,
+        MethodForgetSelection, MethodCount
+    };
+    static constexpr const char* kMethodNames[MethodCount] = {
+        "findWords", "searchWords", "getWordFrequency", "updateWordFrequency",
+        "addWord", "removeWord", "getAllWords", "segmentWords", "learnFromFile",
+        "importWords", "exportWords", "mergeFrom", "recordSelection",
+        "forgetSelection"};
+    static constexpr const char* kMethodSpanNames[MethodCount] = {
+        "dictionary.findWords", "dictionary.searchWords", "dictionary.getWordFrequency",
+        "dictionary.updateWordFrequency", "dictionary.addWord", "dictionary.removeWord",
+        "dictionary.getAllWords", "dictionary.segmentWords", "dictionary.learnFromFile",
+        "dictionary.importWords", "dictionary.exportWords", "dictionary.mergeFrom",
+        "dictionary.recordSelection", "dictionary.forgetSelection"};
+    static constexpr int kCacheCounters[] = {SQLITE_DBSTATUS_CACHE_HIT, SQLITE_DBSTATUS_CACHE_MISS,
+                                             SQLITE_DBSTATUS_CACHE_WRITE, SQLITE_DBSTATUS_CACHE_SPILL};
+
+    // Method statistics. The profile trace hook attributes each finished
+    // statement to the method running on its thread (activeMethod_).
+#ifdef LEKHIKA_STATS
+    std::atomic<bool> statsEnabled_{false};
+#endif
+    mutable std::mutex statsMutex_;
+    MethodStats methodStats_[MethodCount];
+    std::int64_t cacheBaseline_[std::size(kCacheCounters)] = {};
+    struct ActiveMethod {
+        const Impl* owner;
+        MethodStats* stats;
+    };
+    static inline thread_local ActiveMethod activeMethod_{nullptr, nullptr};
+    // Set while the library runs housekeeping statements on db_ (the change
+    // watch's poll), so they do not count as activity for idle maintenance.
+    static inline thread_local bool internalStatement_ = false;
+
+    bool statsEnabled() const {
+#ifdef LEKHIKA_STATS
+        return statsEnabled_.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    // Records the latency of one public method call while stats are enabled,
+    // and traces the call as a span.
+    class MethodTimer {
+    public:
+        MethodTimer(Impl& impl, Method method) : span_(kMethodSpanNames[method]) {
+            if (!impl.statsEnabled()) return;
+            impl_ = &impl;
+            previous_ = activeMethod_;
+            activeMethod_ = {&impl, &impl.methodStats_[method]};
+            start_ = std::chrono::steady_clock::now();
+        }
+        ~MethodTimer() {
+            if (!impl_) return;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+            {
+                std::lock_guard<std::mutex> lock(impl_->statsMutex_);
+                record(activeMethod_.stats->latency, static_cast<std::uint64_t>(ns));
+            }
+            activeMethod_ = previous_;
+        }
+        MethodTimer(const MethodTimer&) = delete;
+        MethodTimer& operator=(const MethodTimer&) = delete;
+
+        TraceSpan& span() { return span_; }
+
+    private:
+        TraceSpan span_;
+        Impl* impl_ = nullptr;
+        ActiveMethod previous_{nullptr, nullptr};
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    static void record(LatencyHistogram& histogram, std::uint64_t ns) {
+        std::uint64_t us = ns / 1000;
+        int bucket = 0;
+        while (bucket < LatencyHistogram::kBuckets - 1 && (us >> (bucket + 1)) != 0) ++bucket;
+        histogram.buckets[bucket]++;
+        histogram.count++;
+        histogram.totalNanoseconds += ns;
+        histogram.maxNanoseconds = std::max(histogram.maxNanoseconds, ns);
+    }
+
+    // SQLITE_TRACE_STMT feeds the idle-maintenance clock, except for
+    // internalStatement_; SQLITE_TRACE_PROFILE (only registered while stats
+    // are on) fires when a statement finishes.
+    static int traceCallback(unsigned type, void* ctx, void* p, void*) {
+        Impl* impl = static_cast<Impl*>(ctx);
+        if (type == SQLITE_TRACE_STMT) {
+            if (!internalStatement_) impl->lastActivity_.store(nowTicks(), std::memory_order_relaxed);
+        } else if (type == SQLITE_TRACE_PROFILE && activeMethod_.owner == impl) {
+            // Read-and-reset, so statements stepped again after sqlite3_reset count once.
+            auto* stmt = static_cast<sqlite3_stmt*>(p);
+            std::lock_guard<std::mutex> lock(impl->statsMutex_);
+            MethodStats& stats = *activeMethod_.stats;
+            stats.statements++;
+            stats.vmSteps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+            stats.fullScanSteps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+            stats.sorts += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+            stats.autoIndexRows += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+        }
+        return 0;
+    }
+
+    static std::int64_t dbStatus(sqlite3* db, int op) {
+        int current = 0, highwater = 0;
+        sqlite3_db_status(db, op, &current, &highwater, 0);
+        return current;
+    }
 
     explicit Impl(const std::string& dbPath) {
         fs::path finalDbPath;
@@ -274,175 +901,1604 @@ public:
         }
 
         fs::create_directories(finalDbPath.parent_path());
-        bool dbExists = fs::exists(finalDbPath);
+        dbPath_ = finalDbPath.string();
+
+        if (sqlite3_open(finalDbPath.c_str(), &db_) != SQLITE_OK) {
+            std::string errMsg = db_ ? sqlite3_errmsg(db_) : "SQLite failed to open database";
+            db_ = nullptr; // Ensure db_ is null on failure
+            throw std::runtime_error("Can't open database: " + errMsg);
+        }
+
+        // Wait instead of failing immediately while a background job holds the write lock.
+        setBusyTimeout(db_, 5000);
+        hasCollator_ = registerFunctions(db_);
+        sqlite3_trace_v2(db_, SQLITE_TRACE_STMT, traceCallback, this);
+
+        // Checked against the schema rather than the file, since another
+        // connection may have created the file but not yet the tables.
+        if (pragmaInt(db_, "SELECT count(*) FROM sqlite_master WHERE name = 'words';") == 0) {
+            initializeDatabase();
+        }
+        upgradeSchema();
+        // Keys for rows of an older dictionary: a small one is done here, a
+        // large one is finished by maintain(). Never waits for the write lock.
+        setBusyTimeout(db_, 0);
+        keysComplete_ = fillDerivedColumns(db_, hasCollator_,
+                                           std::chrono::steady_clock::now() + std::chrono::milliseconds(50));
+        setBusyTimeout(db_, 5000);
+        dataVersion_ = pragmaInt(db_, "PRAGMA data_version;");
+    }
+
+    ~Impl() {
+        stopChangeWatch();
+        stopIdleMaintenance();
+        learnCancel_ = true;
+        if (learnWorker_.joinable()) {
+            learnWorker_.join();
+        }
+        if (db_) {
+            sqlite3_close(db_);
+        }
+    }
+
+    static std::int64_t nowTicks() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // Like sqlite3_busy_timeout(), but retries every millisecond instead of
+    // backing off to 100 ms sleeps, which would rarely land in the short gap
+    // a learn job leaves between its batches.
+    static void setBusyTimeout(sqlite3* db, int timeoutMs) {
+        if (timeoutMs <= 0) {
+            sqlite3_busy_handler(db, nullptr, nullptr);
+            return;
+        }
+        sqlite3_busy_handler(db, [](void* ctx, int attempts) -> int {
+            const auto deadline = reinterpret_cast<std::intptr_t>(ctx);
+            if (attempts >= deadline) return 0;
+            sqlite3_sleep(1);
+            return 1;
+        }, reinterpret_cast<void*>(static_cast<std::intptr_t>(timeoutMs)));
+    }
+
+    // Opens a secondary connection to the dictionary, for work that must not
+    // share db_'s transaction state (background jobs, maintenance).
+    static sqlite3* openConnection(const std::string& path, int busyTimeoutMs) {
+        sqlite3* db = nullptr;
+        if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+            std::string err = db ? sqlite3_errmsg(db) : "SQLite failed to open database";
+            sqlite3_close(db);
+            throw std::runtime_error("Can't open database: " + err);
+        }
+        setBusyTimeout(db, busyTimeoutMs);
+        registerFunctions(db);
+        return db;
+    }
+
+    static std::int64_t pragmaInt(sqlite3* db, const char* sql) {
+        std::int64_t value = 0;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) value = sqlite3_column_int64(stmt, 0);
+            sqlite3_finalize(stmt);
+        }
+        return value;
+    }
+
+    // High-water mark of the change log. AUTOINCREMENT keeps it in
+    // sqlite_sequence, so it survives pruning (MAX(seq) would drop to 0).
+    static std::int64_t changeSequence(sqlite3* db) {
+        return pragmaInt(db, "SELECT IFNULL((SELECT seq FROM sqlite_sequence WHERE name = 'changes'), 0);");
+    }
+
+    static bool hasChangeLog(sqlite3* db) {
+        return pragmaInt(db, "SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name = 'changes';") != 0;
+    }
+
+    // Creates the change log for delta sync on first use, so dictionaries
+    // that never sync pay nothing for it. Triggers record every frequency
+    // change from then on, whichever connection or process makes it. Words
+    // that predate the log are not in it: the pruned floor is set past them,
+    // so exportDelta(0) asks for a full sync instead of returning a partial
+    // delta.
+    static void enableChangeLog(sqlite3* db) {
+        if (hasChangeLog(db)) return;
+        auto exec = [db](const char* sql) {
+            char* errMsg = nullptr;
+            if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+                std::string err = "Failed to enable the change log: " + std::string(errMsg ? errMsg : sqlite3_errmsg(db));
+                sqlite3_free(errMsg);
+                throw std::runtime_error(err);
+            }
+        };
+        exec("BEGIN IMMEDIATE;");
+        try {
+            // Another connection may have created it while we waited for the lock.
+            if (!hasChangeLog(db)) {
+                exec("CREATE TABLE changes ("
+                     "seq INTEGER PRIMARY KEY AUTOINCREMENT,"
+                     "word TEXT NOT NULL,"
+                     "op INTEGER NOT NULL,"
+                     "delta INTEGER NOT NULL);"
+                     "CREATE TRIGGER IF NOT EXISTS words_log_insert AFTER INSERT ON words BEGIN "
+                     "INSERT INTO changes (word, op, delta) VALUES (new.word, 0, new.frequency); END;"
+                     "CREATE TRIGGER IF NOT EXISTS words_log_update AFTER UPDATE OF frequency ON words "
+                     "WHEN new.frequency != old.frequency BEGIN "
+                     "INSERT INTO changes (word, op, delta) VALUES (new.word, 1, new.frequency - old.frequency); END;"
+                     "CREATE TRIGGER IF NOT EXISTS words_log_delete AFTER DELETE ON words BEGIN "
+                     "INSERT INTO changes (word, op, delta) VALUES (old.word, 2, -old.frequency); END;");
+                if (pragmaInt(db, "SELECT EXISTS (SELECT 1 FROM words);")) {
+                    // Advance the sequence to 1 without leaving an entry behind.
+                    exec("INSERT INTO changes (word, op, delta) VALUES ('', 1, 0);"
+                         "DELETE FROM changes;"
+                         "INSERT INTO meta (key, value) VALUES ('changes_pruned_upto', 1) "
+                         "ON CONFLICT(key) DO UPDATE SET value = excluded.value;");
+                }
+            }
+            exec("COMMIT;");
+        } catch (...) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            throw;
+        }
+    }
+
+    // Highest sequence number discarded by pruneChangeLog(); a delta starting
+    // below it would be missing changes.
+    static std::int64_t prunedChangeSequence(sqlite3* db) {
+        return pragmaInt(db, "SELECT IFNULL((SELECT CAST(value AS INTEGER) FROM meta "
+                             "WHERE key = 'changes_pruned_upto'), 0);");
+    }
+
+    // One time-bounded maintenance pass on a private connection:
+    // ANALYZE/optimize, incremental vacuum in small slices, then (budget
+    // permitting) a rebuild of one index, round-robin across calls.
+    MaintenanceReport runMaintenance(std::chrono::milliseconds budget) {
+        std::lock_guard<std::mutex> lock(maintenanceMutex_);
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        const auto deadline = start + budget;
+        MaintenanceReport report;
+
+        // Never wait on other writers: maintenance just tries again later.
+        sqlite3* db = openConnection(dbPath_, 0);
+        const std::int64_t pageSize = pragmaInt(db, "PRAGMA page_size;");
+
+        // analysis_limit keeps ANALYZE approximate and fast on large tables.
+        if (sqlite3_exec(db, "PRAGMA analysis_limit = 1000; ANALYZE; PRAGMA optimize;",
+                         nullptr, nullptr, nullptr) == SQLITE_OK) {
+            report.analyzed = true;
+        }
+
+        // Finishes the one-time key migration of an older dictionary.
+        const bool keysDone = fillDerivedColumns(db, hasCollator_, deadline);
+        keysComplete_ = keysDone;
+
+        bool vacuumDone = true;
+        if (pragmaInt(db, "PRAGMA auto_vacuum;") == 2) { // INCREMENTAL
+            std::int64_t freePages;
+            while ((freePages = pragmaInt(db, "PRAGMA freelist_count;")) > 0) {
+                if (Clock::now() >= deadline) {
+                    vacuumDone = false;
+                    break;
+                }
+                if (sqlite3_exec(db, "PRAGMA incremental_vacuum(128);", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                    vacuumDone = false;
+                    break;
+                }
+                report.bytesReclaimed += (freePages - pragmaInt(db, "PRAGMA freelist_count;")) * pageSize;
+            }
+        } else {
+            report.reclaimableBytes = pragmaInt(db, "PRAGMA freelist_count;") * pageSize;
+        }
+
+        static const char* kIndexes[] = {"idx_sort_key", "idx_word_key"};
+        if (Clock::now() < start + budget / 2) {
+            std::string sql = std::string("REINDEX ") + kIndexes[nextReindex_ % std::size(kIndexes)] + ";";
+            if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK) {
+                report.indexesRebuilt++;
+                nextReindex_++;
+            }
+        }
+        sqlite3_close(db);
+
+        report.complete = keysDone && vacuumDone && report.analyzed;
+        report.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return report;
+    }
+
+    void stopIdleMaintenance() {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            idleStop_ = true;
+        }
+        idleCv_.notify_all();
+        if (idleWorker_.joinable()) {
+            idleWorker_.join();
+        }
+    }
+
+    // data_version on db_ only changes when some other connection (another
+    // process, or this library's background jobs) commits, so our own writes
+    // never count as external.
+    bool pollExternalChanges() {
+        internalStatement_ = true;
+        std::int64_t version = pragmaInt(db_, "PRAGMA data_version;");
+        internalStatement_ = false;
+        if (dataVersion_.exchange(version) == version) return false;
+        segmenterDirty_ = true;
+        if (selectionsLoaded_) loadSelections();
+        std::vector<ChangeCallback> listeners;
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex_);
+            for (const auto& [id, cb] : changeListeners_) listeners.push_back(cb);
+        }
+        for (const auto& cb : listeners) cb();
+        return true;
+    }
+
+    // Reads under the write lock, so a recordSelection() that commits while
+    // this runs either lands in the result or is applied after it.
+    void loadSelections() {
+        TraceSpan span("dictionary.reload-selections");
+        std::unique_lock<std::shared_mutex> lock(selectionsMutex_);
+        std::unordered_map<std::string, std::string> loaded;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db_, "SELECT roman, devanagari FROM selections;", -1, &stmt, nullptr) == SQLITE_OK) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                loaded.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                               reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+            }
+            sqlite3_finalize(stmt);
+        }
+        if (span) span.addEndAttribute("selections", std::to_string(loaded.size()));
+        selections_.swap(loaded);
+        selectionsLoaded_ = true;
+    }
+
+    void stopChangeWatch() {
+        {
+            std::lock_guard<std::mutex> lock(watchMutex_);
+            watchStop_ = true;
+        }
+        watchCv_.notify_all();
+        if (watchWorker_.joinable()) {
+            watchWorker_.join();
+        }
+    }
+
+    std::shared_ptr<const SegmentationTrie> segmenter() {
+        std::lock_guard<std::mutex> lock(segmenterMutex_);
+        if (!segmenter_ || segmenterDirty_.exchange(false)) {
+            TraceSpan span("dictionary.rebuild-segmenter");
+            segmenter_ = std::make_shared<const SegmentationTrie>(db_);
+        }
+        return segmenter_;
+    }
+
+    // Words a learn job added, with how often, so that a failed or cancelled
+    // job can take them back out after its batches were committed.
+    using LearnedWords = std::unordered_map<std::string, std::int64_t>;
+
+    // Shared ingest loop for learnFromFile() and learnFromFileAsync(). Commits
+    // in batches of at most kLearnBatchLines lines or kLearnBatchBytes bytes,
+    // so other writers get the lock between batches; inside a transaction the
+    // caller opened, it adds to that instead. Stops early, between batches,
+    // when `cancel` becomes true. With a segmenter, tokens that fail
+    // validation are split into dictionary words.
+    static void learnFromStream(sqlite3* db, std::istream& in, LearnStats& stats,
+                                const std::atomic<bool>* cancel,
+                                const LearnProgressCallback& onProgress,
+                                const SegmentationTrie* segmenter,
+                                LearnedWords& learned) {
+        constexpr std::uint64_t kLearnBatchLines = 16384;
+        constexpr std::uint64_t kLearnBatchBytes = 1024 * 1024;
+        constexpr auto kLearnBatchTime = std::chrono::milliseconds(20);
+        const bool batched = sqlite3_get_autocommit(db) != 0;
+
+        // Most tokens are known words: bump those, and compute keys only
+        // when a word is new.
+        sqlite3_stmt* bump = nullptr;
+        sqlite3_stmt* insert = nullptr;
+        if (sqlite3_prepare_v2(db, "UPDATE words SET frequency = frequency + 1 WHERE word = ?1;",
+                               -1, &bump, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db, "INSERT INTO words (word, sort_key, word_key) "
+                                   "VALUES (?1, lekhika_sort_key(?1), lekhika_compact_key(?1));",
+                               -1, &insert, nullptr) != SQLITE_OK) {
+            std::string err = sqlite3_errmsg(db);
+            sqlite3_finalize(bump);
+            throw std::runtime_error("Failed to prepare insert: " + err);
+        }
+        auto exec = [&](const char* statement) {
+            if (sqlite3_exec(db, statement, nullptr, nullptr, nullptr) != SQLITE_OK) {
+                throw std::runtime_error("SQL error: " + std::string(sqlite3_errmsg(db)));
+            }
+        };
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        auto lastReport = start;
+        auto updateRate = [&](Clock::time_point now) {
+            stats.elapsedSeconds = std::chrono::duration<double>(now - start).count();
+            stats.wordsPerSecond = stats.elapsedSeconds > 0 ? stats.wordsLearned / stats.elapsedSeconds : 0.0;
+        };
+
+        auto learnWord = [&](const std::string& word) {
+            sqlite3_bind_text(bump, 1, word.c_str(), static_cast<int>(word.size()), SQLITE_TRANSIENT);
+            int rc = sqlite3_step(bump);
+            sqlite3_reset(bump);
+            if (rc == SQLITE_DONE && sqlite3_changes(db) == 0) {
+                sqlite3_bind_text(insert, 1, word.c_str(), static_cast<int>(word.size()), SQLITE_TRANSIENT);
+                rc = sqlite3_step(insert);
+                sqlite3_reset(insert);
+            }
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error("Failed to learn word: " + std::string(sqlite3_errmsg(db)));
+            }
+            learned[word]++;
+            stats.wordsLearned++;
+        };
+
+        // One transaction and one trace span per batch.
+        std::optional<TraceSpan> chunk;
+        bool inBatch = false;
+        try {
+            std::string line;
+            std::uint64_t batchLines = 0, batchBytes = 0;
+            Clock::time_point batchStart;
+            while (true) {
+                if (!inBatch) {
+                    chunk.emplace("dictionary.learn-chunk");
+                    if (batched) exec("BEGIN IMMEDIATE;");
+                    inBatch = true;
+                    batchStart = Clock::now();
+                }
+                bool more = static_cast<bool>(std::getline(in, line));
+                if (more) {
+                    stats.bytesRead += line.size() + 1;
+                    batchBytes += line.size() + 1;
+                    // Trim whitespace
+                    line.erase(0, line.find_first_not_of(" \t\n\r"));
+                    line.erase(line.find_last_not_of(" \t\n\r") + 1);
+                    if (!line.empty()) {
+                        stats.tokensSeen++;
+                        std::vector<std::string> pieces;
+                        bool allKnown = false;
+                        if (segmenter) {
+                            pieces = segmenter->segment(icu::UnicodeString::fromUTF8(line), &allKnown);
+                        }
+                        if (pieces.size() > 1 && allKnown) {
+                            // Run-together dictionary words: learn the parts, not the run.
+                            for (const auto& piece : pieces) learnWord(piece);
+                        } else if (isValidDevanagariWord(line)) {
+                            learnWord(line);
+                        } else {
+                            for (const auto& piece : pieces) {
+                                if (isValidDevanagariWord(piece)) learnWord(piece);
+                            }
+                        }
+                    }
+                    // The clock is read only every 64 lines to keep the loop cheap.
+                    if (++batchLines < kLearnBatchLines && batchBytes < kLearnBatchBytes &&
+                        ((batchLines & 63) != 0 || Clock::now() - batchStart < kLearnBatchTime)) {
+                        continue;
+                    }
+                }
+                if (batched) exec("COMMIT;");
+                inBatch = false;
+                if (*chunk) chunk->addEndAttribute("words_learned", std::to_string(stats.wordsLearned));
+                chunk.reset();
+                batchLines = batchBytes = 0;
+                if (!more) break;
+                if (batched) sqlite3_sleep(1); // Leave a gap for waiting writers
+                if (cancel && cancel->load(std::memory_order_relaxed)) {
+                    stats.cancelled = true;
+                    break;
+                }
+                auto now = Clock::now();
+                if (onProgress && now - lastReport >= std::chrono::milliseconds(100)) {
+                    updateRate(now);
+                    onProgress(stats);
+                    lastReport = now;
+                }
+            }
+        } catch (...) {
+            if (inBatch && batched) sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            chunk.reset();
+            sqlite3_finalize(bump);
+            sqlite3_finalize(insert);
+            throw;
+        }
+        if (stats.totalBytes && stats.bytesRead > stats.totalBytes) {
+            stats.bytesRead = stats.totalBytes; // Last line may lack a trailing newline
+        }
+        updateRate(Clock::now());
+        sqlite3_finalize(bump);
+        sqlite3_finalize(insert);
+    }
+
+    // Takes back what a learn job added: subtracts each word's count and
+    // deletes the words that only the job had added. Best effort; a word
+    // removed by someone else in the meantime is left alone.
+    static void unlearn(sqlite3* db, const LearnedWords& learned) {
+        if (learned.empty()) return;
+        TraceSpan span("dictionary.unlearn");
+        const bool own = sqlite3_get_autocommit(db) != 0;
+        if (own && sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return;
+        sqlite3_stmt *sub = nullptr, *del = nullptr;
+        if (sqlite3_prepare_v2(db, "UPDATE words SET frequency = frequency - ?2 WHERE word = ?1;", -1, &sub, nullptr) == SQLITE_OK &&
+            sqlite3_prepare_v2(db, "DELETE FROM words WHERE word = ?1 AND frequency <= 0;", -1, &del, nullptr) == SQLITE_OK) {
+            for (const auto& [word, count] : learned) {
+                sqlite3_bind_text(sub, 1, word.data(), static_cast<int>(word.size()), SQLITE_STATIC);
+                sqlite3_bind_int64(sub, 2, count);
+                sqlite3_step(sub);
+                sqlite3_reset(sub);
+                sqlite3_bind_text(del, 1, word.data(), static_cast<int>(word.size()), SQLITE_STATIC);
+                sqlite3_step(del);
+                sqlite3_reset(del);
+            }
+        }
+        sqlite3_finalize(sub);
+        sqlite3_finalize(del);
+        if (own) sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+    }
+
+    void initializeDatabase() {
+        const char* sql =
+            // Must precede table creation; lets maintain() return free pages to the OS.
+            "PRAGMA auto_vacuum = INCREMENTAL;"
+            "CREATE TABLE IF NOT EXISTS words ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "word TEXT NOT NULL UNIQUE,"
+            "frequency INTEGER NOT NULL DEFAULT 1);"
+            "CREATE TABLE IF NOT EXISTS meta ("
+            "key TEXT PRIMARY KEY, value TEXT);"
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('format_version', '1.0');"
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('Db', 'lekhika');"
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('language', 'ne');"
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('script', 'Devanagari');"
+            "INSERT OR IGNORE INTO meta (key, value) VALUES ('created_at', strftime('%Y-%m-%d', 'now'));";
+
+
+        char* errMsg = nullptr;
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::string err = "SQL error during initialization: " + std::string(errMsg);
+            sqlite3_free(errMsg);
+            throw std::runtime_error(err);
+        }
+    }
+
+    // Change log operations recorded by the words_log_* triggers.
+    enum ChangeOp { ChangeInsert = 0, ChangeUpdate = 1, ChangeDelete = 2 };
+
+    // SQL function lekhika_sort_key(word): the ICU Nepali collation key of a
+    // word as a BLOB, so that memcmp order of keys is dictionary order.
+    static void sortKeyFunction(sqlite3_context* ctx, int, sqlite3_value** argv) {
+        auto* collator = static_cast<icu::Collator*>(sqlite3_user_data(ctx));
+        const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+        if (!collator || !text) {
+            sqlite3_result_null(ctx);
+            return;
+        }
+        icu::UnicodeString u = icu::UnicodeString::fromUTF8(
+            icu::StringPiece(text, sqlite3_value_bytes(argv[0])));
+        uint8_t buffer[256];
+        int32_t len = collator->getSortKey(u, buffer, sizeof(buffer));
+        if (len <= static_cast<int32_t>(sizeof(buffer))) {
+            sqlite3_result_blob(ctx, buffer, len, SQLITE_TRANSIENT);
+            return;
+        }
+        std::vector<uint8_t> big(len);
+        collator->getSortKey(u, big.data(), len);
+        sqlite3_result_blob(ctx, big.data(), len, SQLITE_TRANSIENT);
+    }
+
+    // SQL function lekhika_compact_key(word): see compactKey().
+    static void compactKeyFunction(sqlite3_context* ctx, int, sqlite3_value** argv) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+        if (!text) {
+            sqlite3_result_null(ctx);
+            return;
+        }
+        std::string key = compactKey(text, static_cast<size_t>(sqlite3_value_bytes(argv[0])));
+        sqlite3_result_blob(ctx, key.data(), static_cast<int>(key.size()), SQLITE_TRANSIENT);
+    }
+
+    // Registers the library's SQL functions on a connection. Each connection
+    // owns its collator, since a Collator must not be shared across threads.
+    // Without Nepali tailoring data the root collation is used; if ICU has no
+    // collation data at all, lekhika_sort_key() returns NULL and false is
+    // returned here.
+    static bool registerFunctions(sqlite3* db) {
+        icu::Collator* collator = nullptr;
+        for (const icu::Locale& locale : {icu::Locale("ne"), icu::Locale::getRoot()}) {
+            UErrorCode status = U_ZERO_ERROR;
+            collator = icu::Collator::createInstance(locale, status);
+            if (U_SUCCESS(status)) break;
+            delete collator;
+            collator = nullptr;
+        }
+        sqlite3_create_function_v2(db, "lekhika_sort_key", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                   collator, sortKeyFunction, nullptr, nullptr,
+                                   [](void* p) { delete static_cast<icu::Collator*>(p); });
+        sqlite3_create_function_v2(db, "lekhika_compact_key", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                   nullptr, compactKeyFunction, nullptr, nullptr, nullptr);
+        return collator != nullptr;
+    }
+
+    // Computes the sort_key and word_key columns for rows that lack them:
+    // rows from format 1.0 dictionaries or written by other tools. This
+    // library's own inserts compute keys as they insert. Works in slices of
+    // one short write transaction each until `deadline`; returns true once
+    // no row is missing a key. Best effort: any SQLite error (such as a busy
+    // database) just leaves the rest for the next call.
+    static bool fillDerivedColumns(sqlite3* db, bool sortKeys, std::chrono::steady_clock::time_point deadline) {
+        // Both probes are index lookups (idx_word_key, idx_sort_key).
+        const char* probe = sortKeys
+            ? "SELECT EXISTS (SELECT 1 FROM words WHERE word_key IS NULL) "
+              "OR EXISTS (SELECT 1 FROM words WHERE sort_key IS NULL);"
+            : "SELECT EXISTS (SELECT 1 FROM words WHERE word_key IS NULL);";
+        if (!pragmaInt(db, probe)) return true;
+        const char* fill = sortKeys
+            ? "UPDATE words SET sort_key = lekhika_sort_key(word), word_key = lekhika_compact_key(word) "
+              "WHERE id IN (SELECT id FROM words WHERE word_key IS NULL OR sort_key IS NULL LIMIT 2000);"
+            : "UPDATE words SET word_key = lekhika_compact_key(word) "
+              "WHERE id IN (SELECT id FROM words WHERE word_key IS NULL LIMIT 2000);";
+        const bool own = sqlite3_get_autocommit(db) != 0;
+        while (true) {
+            if (own && sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+            bool ok = sqlite3_exec(db, fill, nullptr, nullptr, nullptr) == SQLITE_OK;
+            const int filled = ok ? sqlite3_changes(db) : 0;
+            if (own) {
+                ok = ok && sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+                if (!ok) sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            }
+            if (!ok) return false;
+            if (filled < 2000) return true;
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+        }
+    }
+
+    // Adds objects introduced after format 1.0. Runs on every open, so every
+    // statement must be idempotent.
+    void upgradeSchema() {
+        // sort_key: precomputed collation key for dictionary-ordered ByWord paging.
+        // word_key: compact encoding of the word for prefix range scans.
+        for (const char* column : {"sort_key", "word_key"}) {
+            bool hasColumn = false;
+            sqlite3_stmt* stmt;
+            if (sqlite3_prepare_v2(db_, "SELECT 1 FROM pragma_table_info('words') WHERE name = ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_text(stmt, 1, column, -1, SQLITE_STATIC);
+                hasColumn = sqlite3_step(stmt) == SQLITE_ROW;
+                sqlite3_finalize(stmt);
+            }
+            if (!hasColumn) {
+                std::string alter = "ALTER TABLE words ADD COLUMN " + std::string(column) + " BLOB;";
+                sqlite3_exec(db_, alter.c_str(), nullptr, nullptr, nullptr);
+            }
+        }
+
+        const char* sql =
+            // Lookups by word use the UNIQUE constraint's index; format 1.0
+            // also had an identical idx_word.
+            "DROP INDEX IF EXISTS idx_word;"
+            // The index carries the rowid, so (sort_key, id) order needs no
+            // second column.
+            "CREATE INDEX IF NOT EXISTS idx_sort_key ON words(sort_key);"
+            "CREATE INDEX IF NOT EXISTS idx_word_key ON words(word_key);"
+            // The output the user picked for a Roman input, consulted before the rules.
+            "CREATE TABLE IF NOT EXISTS selections ("
+            "roman TEXT PRIMARY KEY,"
+            "devanagari TEXT NOT NULL);";
+
+        char* errMsg = nullptr;
+        if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::string err = "SQL error during schema upgrade: " + std::string(errMsg);
+            sqlite3_free(errMsg);
+            throw std::runtime_error(err);
+        }
+    }
+};
+
+// ----------------- Delta and word list encoding -----------------
+// Delta files are "LKDELTA1", then varint fromSeq, toSeq and record count,
+// followed by records of: u8 kind, varint word length, word bytes and, for
+// kinds other than DeltaDelete, a zigzag varint value.
+namespace {
+constexpr char kDeltaMagic[8] = {'L', 'K', 'D', 'E', 'L', 'T', 'A', '1'};
+constexpr char kWordsMagic[8] = {'L', 'K', 'W', 'O', 'R', 'D', 'S', '1'};
+enum DeltaKind : unsigned char { DeltaAdd = 0, DeltaSet = 1, DeltaDelete = 2 };
+
+void writeVarint(std::ostream& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+bool readVarint(std::istream& in, std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof()) return false;
+        v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t zigzagEncode(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+std::int64_t zigzagDecode(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+} // namespace
+
+//  Public DictionaryManager methods forwarding to Impl
+
+DictionaryManager::DictionaryManager(const std::string& dbPath) : pImpl(std::make_unique<Impl>(dbPath)) {}
+DictionaryManager::~DictionaryManager() = default;
+
+void DictionaryManager::reset() {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot reset: Database is not connected.");
+    }
+    const char* sql = "DELETE FROM words;";
+    char* errMsg = nullptr;
+    if (sqlite3_exec(pImpl->db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error_message = "Failed to reset dictionary: " + std::string(errMsg);
+        sqlite3_free(errMsg);
+        throw std::runtime_error(error_message);
+    }
+    pImpl->segmenterDirty_ = true;
+}
+
+std::map<std::string, std::string> DictionaryManager::getDatabaseInfo() {
+    if (!pImpl->db_) return {};
+    std::map<std::string, std::string> info;
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(pImpl->db_, "SELECT COUNT(*) FROM words;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            info["word_count"] = std::to_string(sqlite3_column_int(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+    }
+    
+    info["change_seq"] = std::to_string(Impl::changeSequence(pImpl->db_));
+    info["cache_hits"] = std::to_string(Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_HIT));
+    info["cache_misses"] = std::to_string(Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_MISS));
+    info["cache_writes"] = std::to_string(Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_WRITE));
+    info["cache_used_bytes"] = std::to_string(Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_USED));
+
+    // Get the full path and replace home directory with ~
+    std::string fullPath = sqlite3_db_filename(pImpl->db_, "main");
+    const char* homeEnv = getenv("HOME");
+    if (homeEnv && fullPath.rfind(homeEnv, 0) == 0) { // Check if path starts with homeEnv
+        info["db_path"] = "~" + fullPath.substr(strlen(homeEnv));
+    } else {
+        info["db_path"] = fullPath;
+    }
+
+    if (sqlite3_prepare_v2(pImpl->db_, "SELECT key, value FROM meta;", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            std::string val = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            info[key] = val;
+        }
+        sqlite3_finalize(stmt);
+    }
+    return info;
+}
+
+long DictionaryManager::learnFromFile(const std::string& filePath) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodLearnFromFile);
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filePath);
+    }
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot learn from file: Database is not connected.");
+    }
+
+    LearnStats stats;
+    Impl::LearnedWords learned;
+    try {
+        auto segmenter = pImpl->segmentOnLearn_ ? pImpl->segmenter() : nullptr;
+        Impl::learnFromStream(pImpl->db_, file, stats, nullptr, nullptr, segmenter.get(), learned);
+    } catch (...) {
+        Impl::unlearn(pImpl->db_, learned); // Take back the batches already committed
+        pImpl->segmenterDirty_ = true;
+        throw;
+    }
+    pImpl->segmenterDirty_ = true;
+    return stats.wordsLearned;
+}
+
+std::future<DictionaryManager::LearnStats> DictionaryManager::learnFromFileAsync(
+    const std::string& filePath, LearnProgressCallback onProgress, bool commitOnCancel) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot learn from file: Database is not connected.");
+    }
+    auto file = std::make_unique<std::ifstream>(filePath, std::ios::binary);
+    if (!file->is_open()) {
+        throw std::runtime_error("Could not open file: " + filePath);
+    }
+    if (pImpl->learnRunning_.exchange(true)) {
+        throw std::runtime_error("A background learn job is already running.");
+    }
+    if (pImpl->learnWorker_.joinable()) {
+        pImpl->learnWorker_.join(); // Reap the previous, already finished job
+    }
+    pImpl->learnCancel_ = false;
+
+    LearnStats initial;
+    std::error_code ec;
+    auto size = fs::file_size(filePath, ec);
+    initial.totalBytes = ec ? 0 : static_cast<std::uint64_t>(size);
+
+    Impl* impl = pImpl.get();
+    auto segmenter = pImpl->segmentOnLearn_ ? pImpl->segmenter() : nullptr;
+    std::packaged_task<LearnStats()> task(
+        [impl, file = std::move(file), onProgress = std::move(onProgress), commitOnCancel, initial, segmenter]() {
+            struct RunningGuard {
+                std::atomic<bool>& flag;
+                ~RunningGuard() { flag = false; }
+            } guard{impl->learnRunning_};
+
+            // A private connection keeps the job's transaction isolated from
+            // calls made on the manager's own connection meanwhile.
+            sqlite3* db = Impl::openConnection(impl->dbPath_, 5000);
+
+            LearnStats stats = initial;
+            Impl::LearnedWords learned;
+            try {
+                Impl::learnFromStream(db, *file, stats, &impl->learnCancel_, onProgress, segmenter.get(), learned);
+                if (!stats.cancelled || commitOnCancel) {
+                    stats.committed = true;
+                } else {
+                    Impl::unlearn(db, learned);
+                }
+            } catch (...) {
+                Impl::unlearn(db, learned);
+                impl->segmenterDirty_ = true;
+                sqlite3_close(db);
+                throw;
+            }
+            impl->segmenterDirty_ = true;
+            sqlite3_close(db);
+            if (onProgress) onProgress(stats);
+            return stats;
+        });
+
+    std::future<LearnStats> result = task.get_future();
+    try {
+        pImpl->learnWorker_ = std::thread(std::move(task));
+    } catch (...) {
+        pImpl->learnRunning_ = false;
+        throw;
+    }
+    return result;
+}
+
+void DictionaryManager::cancelLearning() {
+    pImpl->learnCancel_ = true;
+}
+
+bool DictionaryManager::isLearning() const {
+    return pImpl->learnRunning_;
+}
+
+std::vector<std::string> DictionaryManager::segmentWords(const std::string& text) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodSegmentWords);
+    std::vector<std::string> words;
+    if (!pImpl->db_ || text.empty()) return words;
+    auto segmenter = pImpl->segmenter();
+    std::istringstream iss(text);
+    std::string run;
+    while (iss >> run) {
+        for (auto& piece : segmenter->segment(icu::UnicodeString::fromUTF8(run))) {
+            words.push_back(std::move(piece));
+        }
+    }
+    return words;
+}
+
+void DictionaryManager::setSegmentOnLearn(bool enable) {
+    pImpl->segmentOnLearn_ = enable;
+}
+
+
+long DictionaryManager::mergeFrom(const std::string& otherDbPath, MergePolicy policy) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodMergeFrom);
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot merge: Database is not connected.");
+    }
+    if (!fs::exists(otherDbPath)) {
+        throw std::runtime_error("Could not open file: " + otherDbPath);
+    }
+
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(pImpl->db_, "ATTACH DATABASE ? AS merge_src;", -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to attach database: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    sqlite3_bind_text(stmt, 1, otherDbPath.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to attach database: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+
+    const char* update = policy == MergeMax ? "MAX(frequency, excluded.frequency)"
+                       : policy == MergeReplace ? "excluded.frequency"
+                       : "frequency + excluded.frequency";
+    // "WHERE true" keeps the parser from reading ON CONFLICT as a join constraint.
+    std::string sql = "INSERT INTO main.words (word, frequency, sort_key, word_key) "
+                      "SELECT word, frequency, lekhika_sort_key(word), lekhika_compact_key(word) "
+                      "FROM merge_src.words WHERE true "
+                      "ON CONFLICT(word) DO UPDATE SET frequency = " + std::string(update) + ";";
+
+    long merged = 0;
+    char *errMsg = nullptr;
+    try {
+        beginTransaction();
+        if (sqlite3_exec(pImpl->db_, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::string error = "Failed to merge dictionary: " + std::string(errMsg);
+            sqlite3_free(errMsg);
+            throw std::runtime_error(error);
+        }
+        merged = sqlite3_changes(pImpl->db_);
+        commitTransaction();
+    } catch (...) {
+        rollbackTransaction();
+        sqlite3_exec(pImpl->db_, "DETACH DATABASE merge_src;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    sqlite3_exec(pImpl->db_, "DETACH DATABASE merge_src;", nullptr, nullptr, nullptr);
+    pImpl->segmenterDirty_ = true;
+    return merged;
+}
+
+DictionaryManager::MaintenanceReport DictionaryManager::maintain(std::chrono::milliseconds budget) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot run maintenance: Database is not connected.");
+    }
+    return pImpl->runMaintenance(budget);
+}
+
+void DictionaryManager::enableIncrementalVacuum() {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot enable incremental vacuum: Database is not connected.");
+    }
+    if (Impl::pragmaInt(pImpl->db_, "PRAGMA auto_vacuum;") == 2) return;
+    char *errMsg = nullptr;
+    if (sqlite3_exec(pImpl->db_, "PRAGMA auto_vacuum = INCREMENTAL; VACUUM;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error = "Failed to enable incremental vacuum: " + std::string(errMsg);
+        sqlite3_free(errMsg);
+        throw std::runtime_error(error);
+    }
+}
+
+void DictionaryManager::startIdleMaintenance(std::chrono::milliseconds idleDelay, std::chrono::milliseconds budget) {
+    stopIdleMaintenance();
+    pImpl->idleStop_ = false;
+    pImpl->lastActivity_ = Impl::nowTicks();
+    Impl* impl = pImpl.get();
+    pImpl->idleWorker_ = std::thread([impl, idleDelay, budget]() {
+        // Run once the connection has been idle for idleDelay, and again only
+        // after new writes or while the previous pass left work unfinished.
+        std::int64_t maintainedAtChanges = -1;
+        std::unique_lock<std::mutex> lock(impl->idleMutex_);
+        while (!impl->idleCv_.wait_for(lock, idleDelay, [impl] { return impl->idleStop_; })) {
+            auto idleFor = std::chrono::steady_clock::duration(Impl::nowTicks() - impl->lastActivity_.load());
+            if (idleFor < idleDelay) continue;
+            std::int64_t changes = sqlite3_total_changes64(impl->db_);
+            if (changes == maintainedAtChanges) continue;
+            lock.unlock();
+            MaintenanceReport report;
+            try {
+                report = impl->runMaintenance(budget);
+            } catch (const std::exception&) {
+                // Try again on the next idle period.
+            }
+            lock.lock();
+            if (report.complete) maintainedAtChanges = changes;
+        }
+    });
+}
+
+void DictionaryManager::stopIdleMaintenance() {
+    pImpl->stopIdleMaintenance();
+}
+
+int DictionaryManager::addChangeListener(ChangeCallback callback) {
+    std::lock_guard<std::mutex> lock(pImpl->listenersMutex_);
+    int id = pImpl->nextListenerId_++;
+    pImpl->changeListeners_[id] = std::move(callback);
+    return id;
+}
+
+void DictionaryManager::removeChangeListener(int id) {
+    std::lock_guard<std::mutex> lock(pImpl->listenersMutex_);
+    pImpl->changeListeners_.erase(id);
+}
+
+bool DictionaryManager::pollExternalChanges() {
+    if (!pImpl->db_) return false;
+    return pImpl->pollExternalChanges();
+}
+
+void DictionaryManager::startChangeWatch(std::chrono::milliseconds interval) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot watch for changes: Database is not connected.");
+    }
+    stopChangeWatch();
+    pImpl->watchStop_ = false;
+    Impl* impl = pImpl.get();
+    pImpl->watchWorker_ = std::thread([impl, interval]() {
+        std::unique_lock<std::mutex> lock(impl->watchMutex_);
+        while (!impl->watchCv_.wait_for(lock, interval, [impl] { return impl->watchStop_; })) {
+            lock.unlock();
+            impl->pollExternalChanges();
+            lock.lock();
+        }
+    });
+}
+
+void DictionaryManager::stopChangeWatch() {
+    pImpl->stopChangeWatch();
+}
+
+DictionaryManager::RevalidationReport DictionaryManager::revalidate(RepairAction action, int threads) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot revalidate: Database is not connected.");
+    }
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    RevalidationReport report;
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
 
-        if (sqlite3_open(finalDbPath.c_str(), &db_) != SQLITE_OK) {
-            std::string errMsg = db_ ? sqlite3_errmsg(db_) : "SQLite failed to open database";
-            db_ = nullptr; // Ensure db_ is null on failure
-            throw std::runtime_error("Can't open database: " + errMsg);
-        }
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Normalizer2* nfc = icu::Normalizer2::getNFCInstance(status);
+    if (U_FAILURE(status)) nfc = nullptr;
+
+    struct Row {
+        sqlite3_int64 id;
+        std::string word;
+        sqlite3_int64 frequency;
+        bool valid = true;
+        std::string normalized; // Valid replacement, empty if none
+    };
 
-        if (!dbExists) {
-            initializeDatabase();
-        }
+    sqlite3_stmt *select = nullptr, *remove = nullptr, *merge = nullptr;
+    auto finalizeAll = [&]() {
+        sqlite3_finalize(select);
+        sqlite3_finalize(remove);
+        sqlite3_finalize(merge);
+    };
+    if (sqlite3_prepare_v2(pImpl->db_, "SELECT id, word, frequency FROM words WHERE id > ? ORDER BY id LIMIT ?;", -1, &select, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(pImpl->db_, "DELETE FROM words WHERE id = ?;", -1, &remove, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(pImpl->db_, "INSERT INTO words (word, frequency, sort_key, word_key) "
+                                       "VALUES (?1, ?2, lekhika_sort_key(?1), lekhika_compact_key(?1)) "
+                                       "ON CONFLICT(word) DO UPDATE SET frequency = frequency + excluded.frequency;",
+                           -1, &merge, nullptr) != SQLITE_OK) {
+        std::string err = sqlite3_errmsg(pImpl->db_);
+        finalizeAll();
+        throw std::runtime_error("Failed to prepare revalidation: " + err);
     }
 
-    ~Impl() {
-        if (db_) {
-            sqlite3_close(db_);
+    // Validation runs in parallel per chunk; fixes for the chunk are then
+    // applied in one transaction, so readers are never blocked for long.
+    const int kChunkSize = 50000;
+    const size_t kMaxSamples = 100;
+    std::vector<Row> rows;
+    sqlite3_int64 lastId = 0;
+    try {
+        while (true) {
+            TraceSpan chunk("dictionary.revalidate-chunk");
+            rows.clear();
+            sqlite3_bind_int64(select, 1, lastId);
+            sqlite3_bind_int(select, 2, kChunkSize);
+            while (sqlite3_step(select) == SQLITE_ROW) {
+                rows.push_back({sqlite3_column_int64(select, 0),
+                                reinterpret_cast<const char*>(sqlite3_column_text(select, 1)),
+                                sqlite3_column_int64(select, 2), true, std::string()});
+            }
+            sqlite3_reset(select);
+            if (rows.empty()) break;
+            lastId = rows.back().id;
+
+            auto check = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    Row& row = rows[i];
+                    icu::UnicodeString u = icu::UnicodeString::fromUTF8(row.word);
+                    row.valid = isValidDevanagariWord(u);
+                    if (row.valid || action != RepairNormalize) continue;
+                    icu::UnicodeString fixed = sanitizeDevanagariWord(u);
+                    if (nfc) {
+                        UErrorCode err = U_ZERO_ERROR;
+                        icu::UnicodeString composed = nfc->normalize(fixed, err);
+                        if (U_SUCCESS(err)) fixed = composed;
+                    }
+                    if (fixed != u && isValidDevanagariWord(fixed)) {
+                        fixed.toUTF8String(row.normalized);
+                    }
+                }
+            };
+            size_t workers = std::min<size_t>(threads, (rows.size() + 999) / 1000);
+            std::vector<std::thread> pool;
+            size_t slice = (rows.size() + workers - 1) / workers;
+            for (size_t w = 1; w < workers; ++w) {
+                pool.emplace_back(check, w * slice, std::min(rows.size(), (w + 1) * slice));
+            }
+            check(0, std::min(rows.size(), slice));
+            for (auto& t : pool) t.join();
+
+            report.wordsScanned += static_cast<long>(rows.size());
+            bool inTransaction = false;
+            for (const Row& row : rows) {
+                if (row.valid) continue;
+                report.invalidFound++;
+                if (report.sampleOffenders.size() < kMaxSamples) report.sampleOffenders.push_back(row.word);
+                if (action == RepairReportOnly) continue;
+                if (!inTransaction) {
+                    beginTransaction();
+                    inTransaction = true;
+                }
+                // The original row is only removed once its frequency is merged.
+                if (!row.normalized.empty()) {
+                    sqlite3_bind_text(merge, 1, row.normalized.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_bind_int64(merge, 2, row.frequency);
+                    int rc = sqlite3_step(merge);
+                    sqlite3_reset(merge);
+                    if (rc != SQLITE_DONE) {
+                        throw std::runtime_error("Failed to merge normalized word: " + std::string(sqlite3_errmsg(pImpl->db_)));
+                    }
+                }
+                sqlite3_bind_int64(remove, 1, row.id);
+                int rc = sqlite3_step(remove);
+                sqlite3_reset(remove);
+                if (rc != SQLITE_DONE) {
+                    throw std::runtime_error("Failed to remove invalid word: " + std::string(sqlite3_errmsg(pImpl->db_)));
+                }
+                if (!row.normalized.empty()) report.normalized++;
+                else report.deleted++;
+            }
+            if (inTransaction) {
+                commitTransaction();
+            }
+            if (chunk) chunk.addEndAttribute("rows", std::to_string(rows.size()));
         }
+    } catch (...) {
+        rollbackTransaction();
+        finalizeAll();
+        throw;
     }
+    finalizeAll();
+    if (report.deleted || report.normalized) pImpl->segmenterDirty_ = true;
+    report.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return report;
+}
 
-    void initializeDatabase() {
-        const char* sql =
-            "CREATE TABLE IF NOT EXISTS words ("
-            "id INTEGER PRIMARY KEY AUTOINCREMENT,"
-            "word TEXT NOT NULL UNIQUE,"
-            "frequency INTEGER NOT NULL DEFAULT 1);"
-            "CREATE INDEX IF NOT EXISTS idx_word ON words(word);"
-            "CREATE TABLE IF NOT EXISTS meta ("
-            "key TEXT PRIMARY KEY, value TEXT);"
-            "INSERT OR IGNORE INTO meta (key, value) VALUES ('format_version', '1.0');"
-            "INSERT OR IGNORE INTO meta (key, value) VALUES ('Db', 'lekhika');"
-            "INSERT OR IGNORE INTO meta (key, value) VALUES ('language', 'ne');"
-            "INSERT OR IGNORE INTO meta (key, value) VALUES ('script', 'Devanagari');"
-            "INSERT OR IGNORE INTO meta (key, value) VALUES ('created_at', strftime('%Y-%m-%d', 'now'));";
+void DictionaryManager::recordSelection(const std::string& roman, const std::string& devanagari) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodRecordSelection);
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot record selection: Database is not connected.");
+    }
+    if (roman.empty() || devanagari.empty()) return;
+    sqlite3_stmt *stmt;
+    const char *sql = "INSERT INTO selections (roman, devanagari) VALUES (?, ?) "
+                      "ON CONFLICT(roman) DO UPDATE SET devanagari = excluded.devanagari;";
+    if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to record selection: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    sqlite3_bind_text(stmt, 1, roman.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, devanagari.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to record selection: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    // The in-memory copy only changes once the database has. Before the
+    // first lookup there is no copy; loading it will pick the row up.
+    std::unique_lock<std::shared_mutex> lock(pImpl->selectionsMutex_);
+    if (pImpl->selectionsLoaded_) pImpl->selections_[roman] = devanagari;
+}
 
+bool DictionaryManager::lookupSelection(const std::string& roman, std::string& devanagari) const {
+    if (!pImpl->selectionsLoaded_ && pImpl->db_) pImpl->loadSelections();
+    std::shared_lock<std::shared_mutex> lock(pImpl->selectionsMutex_);
+    auto it = pImpl->selections_.find(roman);
+    if (it == pImpl->selections_.end()) return false;
+    devanagari = it->second;
+    return true;
+}
 
-        char* errMsg = nullptr;
-        if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
-            std::string err = "SQL error during initialization: " + std::string(errMsg);
-            sqlite3_free(errMsg);
-            throw std::runtime_error(err);
-        }
+void DictionaryManager::forgetSelection(const std::string& roman) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodForgetSelection);
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot forget selection: Database is not connected.");
     }
-};
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(pImpl->db_, "DELETE FROM selections WHERE roman = ?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to forget selection: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    sqlite3_bind_text(stmt, 1, roman.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to forget selection: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    std::unique_lock<std::shared_mutex> lock(pImpl->selectionsMutex_);
+    pImpl->selections_.erase(roman);
+}
 
-//  Public DictionaryManager methods forwarding to Impl
+void DictionaryManager::backupTo(const std::string& destPath, int pagesPerStep,
+                                 BackupProgressCallback onProgress) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot back up: Database is not connected.");
+    }
+    std::string tmpPath = destPath + ".tmp";
+    sqlite3* dest = nullptr;
+    if (sqlite3_open(tmpPath.c_str(), &dest) != SQLITE_OK) {
+        std::string err = dest ? sqlite3_errmsg(dest) : "SQLite failed to open database";
+        sqlite3_close(dest);
+        throw std::runtime_error("Can't open backup file: " + err);
+    }
 
-DictionaryManager::DictionaryManager(const std::string& dbPath) : pImpl(std::make_unique<Impl>(dbPath)) {}
-DictionaryManager::~DictionaryManager() = default;
+    // Using the manager's own connection as the source means writes made
+    // through it during the backup are applied to the copy instead of
+    // restarting it.
+    sqlite3_backup* backup = sqlite3_backup_init(dest, "main", pImpl->db_, "main");
+    if (!backup) {
+        std::string err = sqlite3_errmsg(dest);
+        sqlite3_close(dest);
+        fs::remove(tmpPath);
+        throw std::runtime_error("Failed to start backup: " + err);
+    }
+    // Give up once no new page has been copied for this long: the source
+    // stayed locked, or writes from other connections kept restarting the copy.
+    using Clock = std::chrono::steady_clock;
+    const auto kStallLimit = std::chrono::seconds(5);
+    auto lastProgress = Clock::now();
+    int fewestRemaining = -1;
+    bool stalled = false;
+    int rc;
+    do {
+        rc = sqlite3_backup_step(backup, pagesPerStep > 0 ? pagesPerStep : 64);
+        int remaining = sqlite3_backup_remaining(backup);
+        if (onProgress) {
+            onProgress(remaining, sqlite3_backup_pagecount(backup));
+        }
+        if (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            if (rc == SQLITE_OK && (fewestRemaining < 0 || remaining < fewestRemaining)) {
+                fewestRemaining = remaining;
+                lastProgress = Clock::now();
+            } else if (Clock::now() - lastProgress > kStallLimit) {
+                stalled = true;
+                break;
+            }
+            sqlite3_sleep(1); // Let other users of the database in between steps
+        }
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+    sqlite3_backup_finish(backup);
+    rc = rc == SQLITE_DONE ? sqlite3_errcode(dest) : rc;
+    std::string err = stalled ? "no progress for " + std::to_string(kStallLimit.count()) +
+                                " seconds; the database is too busy"
+                              : sqlite3_errmsg(dest);
+    sqlite3_close(dest);
+
+    if (stalled || rc != SQLITE_OK) {
+        fs::remove(tmpPath);
+        throw std::runtime_error("Backup failed: " + err);
+    }
+    fs::rename(tmpPath, destPath);
+}
 
-void DictionaryManager::reset() {
+long DictionaryManager::exportWords(std::ostream& out, WordListFormat format) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodExportWords);
     if (!pImpl->db_) {
-        throw std::runtime_error("Cannot reset: Database is not connected.");
+        throw std::runtime_error("Cannot export words: Database is not connected.");
     }
-    const char* sql = "DELETE FROM words;";
-    char* errMsg = nullptr;
-    if (sqlite3_exec(pImpl->db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
-        std::string error_message = "Failed to reset dictionary: " + std::string(errMsg);
-        sqlite3_free(errMsg);
-        throw std::runtime_error(error_message);
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(pImpl->db_, "SELECT word, frequency FROM words ORDER BY word;", -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to export words: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    if (format == FormatBinary) {
+        out.write(kWordsMagic, sizeof(kWordsMagic));
+    }
+    long count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        int wordLen = sqlite3_column_bytes(stmt, 0);
+        sqlite3_int64 frequency = sqlite3_column_int64(stmt, 1);
+        if (format == FormatBinary) {
+            writeVarint(out, static_cast<std::uint64_t>(wordLen));
+            out.write(word, wordLen);
+            writeVarint(out, static_cast<std::uint64_t>(std::max<sqlite3_int64>(frequency, 0)));
+        } else {
+            out.write(word, wordLen);
+            out << '\t' << frequency << '\n';
+        }
+        count++;
     }
+    sqlite3_finalize(stmt);
+    out.flush();
+    return count;
 }
 
-std::map<std::string, std::string> DictionaryManager::getDatabaseInfo() {
-    if (!pImpl->db_) return {};
-    std::map<std::string, std::string> info;
+long DictionaryManager::importWords(std::istream& in, WordListFormat format, MergePolicy policy) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodImportWords);
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot import words: Database is not connected.");
+    }
+    if (format == FormatBinary) {
+        char magic[sizeof(kWordsMagic)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kWordsMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a lekhika binary word list.");
+        }
+    }
+
+    const char* update = policy == MergeMax ? "MAX(frequency, excluded.frequency)"
+                       : policy == MergeReplace ? "excluded.frequency"
+                       : "frequency + excluded.frequency";
+    std::string sql = "INSERT INTO words (word, frequency, sort_key, word_key) "
+                      "VALUES (?1, ?2, lekhika_sort_key(?1), lekhika_compact_key(?1)) "
+                      "ON CONFLICT(word) DO UPDATE SET frequency = " + std::string(update) + ";";
     sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(pImpl->db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to import words: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
 
-    if (sqlite3_prepare_v2(pImpl->db_, "SELECT COUNT(*) FROM words;", -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            info["word_count"] = std::to_string(sqlite3_column_int(stmt, 0));
+    // Next row from the stream; false at end of input.
+    std::string word, line;
+    sqlite3_int64 frequency = 1;
+    auto nextRow = [&]() -> bool {
+        if (format == FormatBinary) {
+            std::uint64_t len, freq;
+            if (!readVarint(in, len)) return false;
+            if (len > (1u << 20)) throw std::runtime_error("Corrupt binary word list.");
+            word.resize(len);
+            if (!in.read(&word[0], static_cast<std::streamsize>(len)) || !readVarint(in, freq)) {
+                throw std::runtime_error("Corrupt binary word list.");
+            }
+            frequency = static_cast<sqlite3_int64>(freq);
+            return true;
+        }
+        if (!std::getline(in, line)) return false;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t tab = line.find('\t');
+        word = line.substr(0, tab);
+        frequency = 1;
+        if (tab != std::string::npos) {
+            try {
+                frequency = std::stoll(line.substr(tab + 1));
+            } catch (const std::exception&) {
+                frequency = 1;
+            }
         }
+        return true;
+    };
+
+    // One transaction for the whole stream, so an error part-way leaves the
+    // dictionary untouched. Progress is traced in spans of kBatchSize rows.
+    const long kBatchSize = 50000;
+    long imported = 0;
+    long inBatch = 0;
+    std::optional<TraceSpan> batch;
+    try {
+        beginTransaction();
+        batch.emplace("dictionary.import-batch");
+        while (nextRow()) {
+            if (word.empty() || frequency < 1 || !isValidDevanagariWord(word)) continue;
+            sqlite3_bind_text(stmt, 1, word.data(), static_cast<int>(word.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 2, frequency);
+            int rc = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error("Failed to import word: " + std::string(sqlite3_errmsg(pImpl->db_)));
+            }
+            imported++;
+            if (++inBatch == kBatchSize) {
+                if (*batch) batch->addEndAttribute("rows", std::to_string(inBatch));
+                batch.emplace("dictionary.import-batch");
+                inBatch = 0;
+            }
+        }
+        commitTransaction();
+        if (*batch) batch->addEndAttribute("rows", std::to_string(inBatch));
+        batch.reset();
+    } catch (...) {
+        batch.reset();
+        rollbackTransaction();
         sqlite3_finalize(stmt);
+        throw;
     }
-    
-    // Get the full path and replace home directory with ~
-    std::string fullPath = sqlite3_db_filename(pImpl->db_, "main");
-    const char* homeEnv = getenv("HOME");
-    if (homeEnv && fullPath.rfind(homeEnv, 0) == 0) { // Check if path starts with homeEnv
-        info["db_path"] = "~" + fullPath.substr(strlen(homeEnv));
-    } else {
-        info["db_path"] = fullPath;
+    sqlite3_finalize(stmt);
+    pImpl->segmenterDirty_ = true;
+    return imported;
+}
+
+long long DictionaryManager::getChangeSequence() {
+    if (!pImpl->db_) return 0;
+    Impl::enableChangeLog(pImpl->db_);
+    return Impl::changeSequence(pImpl->db_);
+}
+
+long long DictionaryManager::exportDelta(long long sinceSeq, const std::string& filePath) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot export delta: Database is not connected.");
     }
+    Impl::enableChangeLog(pImpl->db_);
+    // Net effect per word since sinceSeq: a trailing delete wins; a delete
+    // followed by re-insertion becomes an absolute value; otherwise deltas sum.
+    const char *sql =
+        "WITH c AS (SELECT seq, word, op, delta FROM changes WHERE seq > ?1), "
+        "d AS (SELECT word, MAX(seq) AS lastDel FROM c WHERE op = 2 GROUP BY word) "
+        "SELECT c.word, d.lastDel, MAX(c.seq) = d.lastDel, "
+        "SUM(CASE WHEN d.lastDel IS NULL OR c.seq > d.lastDel THEN c.delta ELSE 0 END) "
+        "FROM c LEFT JOIN d USING (word) GROUP BY c.word;";
+
+    // One read transaction, so the pruned floor, the log and the end
+    // sequence all come from the same snapshot.
+    beginTransaction();
+    sqlite3_stmt *stmt = nullptr;
+    long long toSeq = 0;
+    std::ostringstream body;
+    std::uint64_t count = 0;
+    try {
+        long long prunedSeq = Impl::prunedChangeSequence(pImpl->db_);
+        if (sinceSeq < prunedSeq) {
+            throw std::runtime_error("Cannot export delta: the change log starts after sequence " + std::to_string(prunedSeq) +
+                                     ", so a delta since " + std::to_string(sinceSeq) +
+                                     " would be incomplete; sync the full word list instead.");
+        }
+        if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to read change log: " + std::string(sqlite3_errmsg(pImpl->db_)));
+        }
+        sqlite3_bind_int64(stmt, 1, sinceSeq);
 
-    if (sqlite3_prepare_v2(pImpl->db_, "SELECT key, value FROM meta;", -1, &stmt, nullptr) == SQLITE_OK) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            std::string val = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            info[key] = val;
+            const char* word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            int wordLen = sqlite3_column_bytes(stmt, 0);
+            bool hadDelete = sqlite3_column_type(stmt, 1) != SQLITE_NULL;
+            bool endsDeleted = sqlite3_column_int(stmt, 2) != 0;
+            std::int64_t value = sqlite3_column_int64(stmt, 3);
+
+            DeltaKind kind = endsDeleted ? DeltaDelete : hadDelete ? DeltaSet : DeltaAdd;
+            if (kind == DeltaAdd && value == 0) continue;
+            body.put(static_cast<char>(kind));
+            writeVarint(body, static_cast<std::uint64_t>(wordLen));
+            body.write(word, wordLen);
+            if (kind != DeltaDelete) writeVarint(body, zigzagEncode(value));
+            count++;
         }
         sqlite3_finalize(stmt);
+        stmt = nullptr;
+        toSeq = std::max<long long>(sinceSeq, Impl::changeSequence(pImpl->db_));
+        commitTransaction();
+    } catch (...) {
+        sqlite3_finalize(stmt);
+        rollbackTransaction();
+        throw;
     }
-    return info;
+
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open file: " + filePath);
+    }
+    out.write(kDeltaMagic, sizeof(kDeltaMagic));
+    writeVarint(out, static_cast<std::uint64_t>(sinceSeq));
+    writeVarint(out, static_cast<std::uint64_t>(toSeq));
+    writeVarint(out, count);
+    out << body.str();
+    if (!out) {
+        throw std::runtime_error("Failed to write delta file: " + filePath);
+    }
+    return toSeq;
 }
 
-long DictionaryManager::learnFromFile(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+long DictionaryManager::importDelta(const std::string& filePath) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot import delta: Database is not connected.");
+    }
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in.is_open()) {
         throw std::runtime_error("Could not open file: " + filePath);
     }
+    char magic[sizeof(kDeltaMagic)];
+    std::uint64_t fromSeq, toSeq, count;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kDeltaMagic, sizeof(magic)) != 0 ||
+        !readVarint(in, fromSeq) || !readVarint(in, toSeq) || !readVarint(in, count)) {
+        throw std::runtime_error("Not a lekhika delta file: " + filePath);
+    }
 
-    long wordsLearned = 0;
-    std::string line;
-    beginTransaction();
+    const char *sqlAdd = "INSERT INTO words (word, frequency, sort_key, word_key) "
+                         "VALUES (?1, ?2, lekhika_sort_key(?1), lekhika_compact_key(?1)) "
+                         "ON CONFLICT(word) DO UPDATE SET frequency = MAX(frequency + ?2, 1);";
+    const char *sqlSub = "UPDATE words SET frequency = MAX(frequency + ?2, 1) WHERE word = ?1;";
+    const char *sqlSet = "INSERT INTO words (word, frequency, sort_key, word_key) "
+                         "VALUES (?1, ?2, lekhika_sort_key(?1), lekhika_compact_key(?1)) "
+                         "ON CONFLICT(word) DO UPDATE SET frequency = excluded.frequency;";
+    const char *sqlDel = "DELETE FROM words WHERE word = ?1;";
+    sqlite3_stmt *stmts[4] = {nullptr, nullptr, nullptr, nullptr};
+    auto finalizeAll = [&]() { for (auto* st : stmts) sqlite3_finalize(st); };
+    const char* sqls[4] = {sqlAdd, sqlSub, sqlSet, sqlDel};
+    for (int i = 0; i < 4; ++i) {
+        if (sqlite3_prepare_v2(pImpl->db_, sqls[i], -1, &stmts[i], nullptr) != SQLITE_OK) {
+            std::string err = sqlite3_errmsg(pImpl->db_);
+            finalizeAll();
+            throw std::runtime_error("Failed to prepare delta import: " + err);
+        }
+    }
+
+    // IMMEDIATE, so no other connection can log changes between reading the
+    // sequence and pruning the import's own entries below.
+    if (sqlite3_exec(pImpl->db_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::string err = sqlite3_errmsg(pImpl->db_);
+        finalizeAll();
+        throw std::runtime_error("SQL error: " + err);
+    }
+    long applied = 0;
     try {
-        while (std::getline(file, line)) {
-            // Trim whitespace
-            line.erase(0, line.find_first_not_of(" \t\n\r"));
-            line.erase(line.find_last_not_of(" \t\n\r") + 1);
-            if (!line.empty() && isValidDevanagariWord(line)) {
-                addWord(line);
-                wordsLearned++;
+        std::int64_t localSeq = Impl::changeSequence(pImpl->db_);
+        std::string word;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            int kind = in.get();
+            std::uint64_t len = 0, raw = 0;
+            if (kind == std::char_traits<char>::eof() || kind > DeltaDelete || !readVarint(in, len) || len > (1u << 20)) {
+                throw std::runtime_error("Corrupt delta file: " + filePath);
+            }
+            word.resize(len);
+            if (!in.read(&word[0], static_cast<std::streamsize>(len)) ||
+                (kind != DeltaDelete && !readVarint(in, raw))) {
+                throw std::runtime_error("Corrupt delta file: " + filePath);
+            }
+            std::int64_t value = zigzagDecode(raw);
+            sqlite3_stmt* st = kind == DeltaDelete ? stmts[3]
+                             : kind == DeltaSet ? stmts[2]
+                             : value > 0 ? stmts[0] : stmts[1];
+            sqlite3_bind_text(st, 1, word.data(), static_cast<int>(word.size()), SQLITE_TRANSIENT);
+            if (kind != DeltaDelete) sqlite3_bind_int64(st, 2, value);
+            int rc = sqlite3_step(st);
+            sqlite3_reset(st);
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error("Failed to apply delta: " + std::string(sqlite3_errmsg(pImpl->db_)));
+            }
+            applied++;
+        }
+        // Imported changes are not local changes: drop the range the import
+        // logged so they are not echoed back to the machine they came from.
+        if (Impl::hasChangeLog(pImpl->db_)) {
+            sqlite3_stmt *prune;
+            if (sqlite3_prepare_v2(pImpl->db_, "DELETE FROM changes WHERE seq > ?1 AND seq <= ?2;", -1, &prune, nullptr) != SQLITE_OK) {
+                throw std::runtime_error("Failed to prune imported changes: " + std::string(sqlite3_errmsg(pImpl->db_)));
+            }
+            sqlite3_bind_int64(prune, 1, localSeq);
+            sqlite3_bind_int64(prune, 2, Impl::changeSequence(pImpl->db_));
+            int rc = sqlite3_step(prune);
+            sqlite3_finalize(prune);
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error("Failed to prune imported changes: " + std::string(sqlite3_errmsg(pImpl->db_)));
             }
         }
         commitTransaction();
     } catch (...) {
         rollbackTransaction();
-        throw; // Re-throw the exception after rolling back
+        finalizeAll();
+        throw;
     }
-    return wordsLearned;
+    finalizeAll();
+    pImpl->segmenterDirty_ = true;
+    return applied;
 }
 
+void DictionaryManager::pruneChangeLog(long long uptoSeq) {
+    if (!pImpl->db_) {
+        throw std::runtime_error("Cannot prune change log: Database is not connected.");
+    }
+    if (!Impl::hasChangeLog(pImpl->db_)) return;
+    auto run = [this](const char* sql, long long value) {
+        sqlite3_stmt *stmt;
+        if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to prune change log: " + std::string(sqlite3_errmsg(pImpl->db_)));
+        }
+        sqlite3_bind_int64(stmt, 1, value);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to prune change log: " + std::string(sqlite3_errmsg(pImpl->db_)));
+        }
+    };
+    beginTransaction();
+    try {
+        run("DELETE FROM changes WHERE seq <= ?;", uptoSeq);
+        // The floor is capped at the current sequence (stable now that the
+        // DELETE holds the write lock): later entries were never pruned.
+        long long floor = std::min<long long>(uptoSeq, Impl::changeSequence(pImpl->db_));
+        run("INSERT INTO meta (key, value) VALUES ('changes_pruned_upto', ?1) "
+            "ON CONFLICT(key) DO UPDATE SET value = MAX(CAST(value AS INTEGER), CAST(excluded.value AS INTEGER));",
+            floor);
+        commitTransaction();
+    } catch (...) {
+        rollbackTransaction();
+        throw;
+    }
+}
 
 void DictionaryManager::addWord(const std::string &word) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodAddWord);
     if (!pImpl->db_) {
         throw std::runtime_error("Cannot add word: Database is not connected.");
     }
     sqlite3_stmt *stmt;
-    const char *sql = "INSERT INTO words (word) VALUES (?) "
+    const char *sql = "INSERT INTO words (word, sort_key, word_key) "
+                      "VALUES (?1, lekhika_sort_key(?1), lekhika_compact_key(?1)) "
                       "ON CONFLICT(word) DO UPDATE SET frequency = frequency + 1;";
 
-    if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+    if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        throw std::runtime_error("Failed to add word: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to add word: " + std::string(sqlite3_errmsg(pImpl->db_)));
     }
+    pImpl->segmenterDirty_ = true;
 }
 
 void DictionaryManager::removeWord(const std::string &word) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodRemoveWord);
     if (!pImpl->db_) {
         throw std::runtime_error("Cannot remove word: Database is not connected.");
     }
     sqlite3_stmt *stmt;
     const char *sql = "DELETE FROM words WHERE word = ?;";
-    if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+    if (sqlite3_prepare_v2(pImpl->db_, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        throw std::runtime_error("Failed to remove word: " + std::string(sqlite3_errmsg(pImpl->db_)));
     }
+    sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to remove word: " + std::string(sqlite3_errmsg(pImpl->db_)));
+    }
+    pImpl->segmenterDirty_ = true;
 }
 
 std::vector<std::string> DictionaryManager::findWords(const std::string &input, int limit) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodFindWords);
     std::vector<std::string> results;
     if (!pImpl->db_ || input.empty()) return results;
     sqlite3_stmt *stmt = nullptr;
 
-    const char *sqlPrefix = "SELECT word FROM words WHERE word LIKE ? ORDER BY frequency DESC LIMIT ?;";
+    // Prefix match as a range scan on idx_word_key: [key(prefix), key(prefix)+1).
+    // Rows not yet given a key (see fillDerivedColumns()) are compared
+    // directly; once every row has one, that branch is a single index probe.
+    std::string lo = compactKey(input.data(), input.size());
+    std::string hi = lo;
+    while (!hi.empty() && static_cast<unsigned char>(hi.back()) == 0xFF) hi.pop_back();
+    if (!hi.empty()) hi.back() = static_cast<char>(static_cast<unsigned char>(hi.back()) + 1);
+
+    const char *sqlPrefix = hi.empty()
+        ? "SELECT word FROM words WHERE word_key >= ?1 "
+          "OR (word_key IS NULL AND substr(word, 1, length(?4)) = ?4) ORDER BY frequency DESC LIMIT ?3;"
+        : "SELECT word FROM words WHERE (word_key >= ?1 AND word_key < ?2) "
+          "OR (word_key IS NULL AND substr(word, 1, length(?4)) = ?4) ORDER BY frequency DESC LIMIT ?3;";
     if (sqlite3_prepare_v2(pImpl->db_, sqlPrefix, -1, &stmt, nullptr) == SQLITE_OK) {
-        std::string pattern = input + "%";
-        sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, limit);
+        sqlite3_bind_blob(stmt, 1, lo.data(), static_cast<int>(lo.size()), SQLITE_TRANSIENT);
+        if (!hi.empty()) sqlite3_bind_blob(stmt, 2, hi.data(), static_cast<int>(hi.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, limit);
+        sqlite3_bind_text(stmt, 4, input.data(), static_cast<int>(input.size()), SQLITE_TRANSIENT);
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             results.emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
         }
         sqlite3_finalize(stmt);
     }
+    if (timer.span()) timer.span().addEndAttribute("results", std::to_string(results.size()));
     return results;
 }
 
 int DictionaryManager::getWordFrequency(const std::string &word) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodGetWordFrequency);
     if (!pImpl->db_){
         // Returning -1 is a reasonable contract for "not found or error"
         return -1;
@@ -461,6 +2517,7 @@ int DictionaryManager::getWordFrequency(const std::string &word) {
 }
 
 bool DictionaryManager::updateWordFrequency(const std::string &word, int frequency) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodUpdateWordFrequency);
     if (!pImpl->db_) {
         // Returning false for failure is acceptable here, but a throw would be more consistent
         return false;
@@ -474,16 +2531,23 @@ bool DictionaryManager::updateWordFrequency(const std::string &word, int frequen
     sqlite3_bind_text(stmt, 2, word.c_str(), -1, SQLITE_TRANSIENT);
     bool success = (sqlite3_step(stmt) == SQLITE_DONE);
     sqlite3_finalize(stmt);
+    pImpl->segmenterDirty_ = true;
     return success && (sqlite3_changes(pImpl->db_) > 0);
 }
 
 std::vector<std::pair<std::string, int>> DictionaryManager::getAllWords(int limit, int offset, SortColumn sortBy, bool ascending) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodGetAllWords);
     std::vector<std::pair<std::string, int>> results;
     if (!pImpl->db_) return results;
     sqlite3_stmt *stmt;
+    std::string direction = ascending ? "ASC" : "DESC";
+    // ByWord walks idx_sort_key, so dictionary-ordered paging needs no runtime
+    // collation. Without a collator, or while older rows still lack keys,
+    // it falls back to code point order.
     std::string sql_str = "SELECT word, frequency FROM words ORDER BY " +
-                        std::string(sortBy == ByFrequency ? "frequency " : "word ") +
-                        std::string(ascending ? "ASC" : "DESC");
+                        (sortBy == ByFrequency ? "frequency " + direction
+                         : pImpl->hasCollator_ && pImpl->keysComplete_ ? "sort_key " + direction + ", id " + direction
+                                                                       : "word " + direction);
     if (limit > 0) sql_str += " LIMIT ?";
     if (offset > 0) sql_str += " OFFSET ?";
     sql_str += ";";
@@ -497,10 +2561,12 @@ std::vector<std::pair<std::string, int>> DictionaryManager::getAllWords(int limi
         }
         sqlite3_finalize(stmt);
     }
+    if (timer.span()) timer.span().addEndAttribute("results", std::to_string(results.size()));
     return results;
 }
 
 std::vector<std::pair<std::string, int>> DictionaryManager::searchWords(const std::string& searchTerm) {
+    Impl::MethodTimer timer(*pImpl, Impl::MethodSearchWords);
     std::vector<std::pair<std::string, int>> results;
     if (!pImpl->db_ || searchTerm.empty()) return results;
     sqlite3_stmt *stmt;
@@ -514,9 +2580,88 @@ std::vector<std::pair<std::string, int>> DictionaryManager::searchWords(const st
         }
         sqlite3_finalize(stmt);
     }
+    if (timer.span()) timer.span().addEndAttribute("results", std::to_string(results.size()));
     return results;
 }
 
+void DictionaryManager::setEnableStats(bool enable) {
+#ifdef LEKHIKA_STATS
+    pImpl->statsEnabled_ = enable;
+    if (pImpl->db_) {
+        sqlite3_trace_v2(pImpl->db_, SQLITE_TRACE_STMT | (enable ? SQLITE_TRACE_PROFILE : 0),
+                         Impl::traceCallback, pImpl.get());
+    }
+#else
+    (void)enable;
+#endif
+}
+
+DictionaryManager::Stats DictionaryManager::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->statsMutex_);
+        for (int i = 0; i < Impl::MethodCount; ++i) {
+            if (pImpl->methodStats_[i].latency.count > 0) {
+                stats.methods[Impl::kMethodNames[i]] = pImpl->methodStats_[i];
+            }
+        }
+        if (pImpl->db_) {
+            std::int64_t* fields[] = {&stats.cacheHits, &stats.cacheMisses, &stats.cacheWrites, &stats.cacheSpills};
+            for (size_t i = 0; i < std::size(Impl::kCacheCounters); ++i) {
+                *fields[i] = Impl::dbStatus(pImpl->db_, Impl::kCacheCounters[i]) - pImpl->cacheBaseline_[i];
+            }
+        }
+    }
+    if (pImpl->db_) stats.cacheUsedBytes = Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_USED);
+    return stats;
+}
+
+void DictionaryManager::resetStats() {
+    std::lock_guard<std::mutex> lock(pImpl->statsMutex_);
+    std::fill(std::begin(pImpl->methodStats_), std::end(pImpl->methodStats_), MethodStats());
+    if (pImpl->db_) {
+        for (size_t i = 0; i < std::size(Impl::kCacheCounters); ++i) {
+            pImpl->cacheBaseline_[i] = Impl::dbStatus(pImpl->db_, Impl::kCacheCounters[i]);
+        }
+    }
+}
+
+double DictionaryManager::LatencyHistogram::percentileMicros(double q) const {
+    if (count == 0) return 0.0;
+    const double maxMicros = maxNanoseconds / 1000.0;
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * count)));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBuckets - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(std::ldexp(1.0, i + 1), maxMicros);
+    }
+    return maxMicros;
+}
+
+MemoryUsage DictionaryManager::memoryUsage() const {
+    // Only structures already in memory are reported; nothing is loaded here.
+    MemoryUsage usage;
+    if (pImpl->selectionsLoaded_.load()) {
+        std::shared_lock<std::shared_mutex> lock(pImpl->selectionsMutex_);
+        usage.bytes["selections.table"] = hashTableBytes(pImpl->selections_);
+        usage.bytes["selections.strings"] = stringPayloadBytes(pImpl->selections_);
+    }
+    std::shared_ptr<const SegmentationTrie> trie;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->segmenterMutex_);
+        trie = pImpl->segmenter_;
+    }
+    if (trie) usage.bytes["segmenter.index"] = trie->memoryBytes();
+    usage.bytes["stats"] = sizeof(pImpl->methodStats_);
+    usage.bytes["object"] = sizeof(Impl) + stringHeapBytes(pImpl->dbPath_);
+    if (pImpl->db_) {
+        usage.bytes["sqlite.pageCache"] = Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_CACHE_USED);
+        usage.bytes["sqlite.schema"] = Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_SCHEMA_USED);
+        usage.bytes["sqlite.statements"] = Impl::dbStatus(pImpl->db_, SQLITE_DBSTATUS_STMT_USED);
+    }
+    return usage;
+}
+
 void DictionaryManager::beginTransaction() {
     if (!pImpl->db_) {
         throw std::runtime_error("Cannot begin transaction: Database is not connected.");
@@ -564,11 +2709,82 @@ public:
     bool enableAutoCorrect_ = true;
     bool enableIndicNumbers_ = true;
     bool enableSymbolsTransliteration_ = true;
+    bool asciiKeys_ = false; // No charMap_ key contains a non-ASCII byte
     fs::path dataDir_;
+#ifdef HAVE_SQLITE3
+    const DictionaryManager* selectionMemory_ = nullptr;
+#endif
+#ifdef LEKHIKA_STATS
+    bool statsEnabled_ = false;
+    bool profiling_ = false;
+#else
+    static constexpr bool statsEnabled_ = false; // Lets the compiler drop every counter site
+    static constexpr bool profiling_ = false;
+#endif
+    Transliteration::Stats stats_;
+
+    // Profiling mode: hits per mapping key, auto-correct word, rule and path.
+    enum Rule {
+        RuleFinalYToEe, RuleAppendSchwa, RuleFinalIToEe, RuleVelarNasal, RuleNgGemination,
+        RuleRetroflexNasal, RulePalatalNasal, RuleCount
+    };
+    static constexpr const char* kRuleNames[RuleCount] = {
+        "final-y-to-ee", "append-schwa", "final-i-to-ee", "n-to-ng-before-k-g", "ng-gemination",
+        "n-to-N-before-T-D", "n-to-nya-before-ch"};
+    enum Path {
+        PathSelectionMemory, PathDigitPassthrough, PathSymbolPassthrough, PathSingleChar, PathAutoCorrect,
+        PathRules, PathSegmentDigitPassthrough, PathSegmentSymbolPassthrough, PathSingleCharFallback,
+        PathUnmappedByte, PathHalantaTrim, PathCount
+    };
+    static constexpr const char* kPathNames[PathCount] = {
+        "word.selection-memory", "word.digit-passthrough", "word.symbol-passthrough", "word.single-char",
+        "word.autocorrect", "word.rules", "segment.digit-passthrough", "segment.symbol-passthrough",
+        "segment.single-char-fallback", "segment.unmapped-byte", "segment.halanta-trim"};
+    std::unordered_map<std::string, std::uint64_t> mappingHits_;
+    std::unordered_map<std::string, std::uint64_t> autoCorrectHits_;
+    mutable std::uint64_t ruleHits_[RuleCount] = {};
+    std::uint64_t pathHits_[PathCount] = {};
+
+    void hitRule(Rule rule) const {
+        if (profiling_) ++ruleHits_[rule];
+    }
+    void hitPath(Path path, std::uint64_t count = 1) {
+        if (profiling_) pathHits_[path] += count;
+    }
+
+    static constexpr const char* kStageSpanNames[Transliteration::StageCount] = {
+        "transliterate.preprocess-input", "transliterate.mask-braces", "transliterate.autocorrect",
+        "transliterate.smart-correction", "transliterate.segment", "transliterate.restore-braces"};
+
+    // Adds the time spent in its scope to one stage, and traces it as a span;
+    // reads no clock while stats are off.
+    class StageTimer {
+    public:
+        StageTimer(Impl& impl, Transliteration::Stage stage, size_t bytes) : span_(kStageSpanNames[stage]) {
+            if (!impl.statsEnabled_) return;
+            stage_ = &impl.stats_.stages[stage];
+            ++stage_->calls;
+            stage_->bytes += bytes;
+            start_ = std::chrono::steady_clock::now();
+        }
+        ~StageTimer() {
+            if (!stage_) return;
+            stage_->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+        }
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        TraceSpan span_;
+        Transliteration::StageStats* stage_ = nullptr;
+        std::chrono::steady_clock::time_point start_;
+    };
 
 #include <filesystem>
 
     explicit Impl(const std::string& dataDir) {
+        TraceSpan span("transliteration.load");
         if (!dataDir.empty()) {
             dataDir_ = dataDir;
         } else if (std::filesystem::exists("/usr/share/liblekhika/")) {
@@ -579,6 +2795,11 @@ public:
 
         loadMappings();
         loadSpecialWords();
+        if (span) {
+            span.addEndAttribute("data_dir", dataDir_.string());
+            span.addEndAttribute("mappings", std::to_string(charMap_.size()));
+            span.addEndAttribute("autocorrect_words", std::to_string(specialWords_.size()));
+        }
     }
 
 
@@ -613,7 +2834,7 @@ public:
 
     void parseSpecialWordsToml(const std::string &content);
     void parseMappingsToml(const std::string &content);
-    std::string transliterateSegment(const std::string &segment);
+    std::string transliterateSegment(const std::string &segment, bool profile = true);
     std::string preprocess(const std::string &word);
     std::string applySmartCorrection(const std::string &word) const;
     std::string applyAutoCorrection(const std::string &word) const;
@@ -630,57 +2851,166 @@ void Transliteration::setEnableSmartCorrection(bool enable) { pImpl->enableSmart
 void Transliteration::setEnableAutoCorrect(bool enable) { pImpl->enableAutoCorrect_ = enable; }
 void Transliteration::setEnableIndicNumbers(bool enable) { pImpl->enableIndicNumbers_ = enable; }
 void Transliteration::setEnableSymbolsTransliteration(bool enable) { pImpl->enableSymbolsTransliteration_ = enable; }
+#ifdef HAVE_SQLITE3
+void Transliteration::setSelectionMemory(const DictionaryManager* dict) { pImpl->selectionMemory_ = dict; }
+#endif
+std::string Transliteration::applySmartCorrection(const std::string &word) const { return pImpl->applySmartCorrection(word); }
+
+void Transliteration::setEnableStats(bool enable) {
+#ifdef LEKHIKA_STATS
+    pImpl->statsEnabled_ = enable;
+#else
+    (void)enable;
+#endif
+}
+Transliteration::Stats Transliteration::getStats() const { return pImpl->stats_; }
+void Transliteration::resetStats() { pImpl->stats_ = Stats(); }
+
+void Transliteration::setEnableProfiling(bool enable) {
+#ifdef LEKHIKA_STATS
+    pImpl->profiling_ = enable;
+#else
+    (void)enable;
+#endif
+}
+
+bool Transliteration::isProfilingEnabled() const { return pImpl->profiling_; }
+
+Transliteration::Profile Transliteration::getProfile() const {
+    Profile profile;
+    for (const auto& [key, value] : pImpl->charMap_) {
+        auto it = pImpl->mappingHits_.find(key);
+        profile.mappingHits[key] = it == pImpl->mappingHits_.end() ? 0 : it->second;
+    }
+    for (const auto& [word, value] : pImpl->specialWords_) {
+        auto it = pImpl->autoCorrectHits_.find(word);
+        profile.autoCorrectHits[word] = it == pImpl->autoCorrectHits_.end() ? 0 : it->second;
+    }
+    for (int i = 0; i < Impl::RuleCount; ++i) profile.ruleHits[Impl::kRuleNames[i]] = pImpl->ruleHits_[i];
+    for (int i = 0; i < Impl::PathCount; ++i) profile.pathHits[Impl::kPathNames[i]] = pImpl->pathHits_[i];
+    return profile;
+}
+
+void Transliteration::resetProfile() {
+    pImpl->mappingHits_.clear();
+    pImpl->autoCorrectHits_.clear();
+    std::fill(std::begin(pImpl->ruleHits_), std::end(pImpl->ruleHits_), 0);
+    std::fill(std::begin(pImpl->pathHits_), std::end(pImpl->pathHits_), 0);
+}
+
+MemoryUsage Transliteration::memoryUsage() const {
+    MemoryUsage usage;
+    usage.bytes["charMap.table"] = hashTableBytes(pImpl->charMap_);
+    usage.bytes["charMap.strings"] = stringPayloadBytes(pImpl->charMap_);
+    usage.bytes["specialWords.table"] = hashTableBytes(pImpl->specialWords_);
+    usage.bytes["specialWords.strings"] = stringPayloadBytes(pImpl->specialWords_);
+    usage.bytes["object"] = sizeof(Impl) + pImpl->dataDir_.native().capacity();
+    return usage;
+}
+
+const char* Transliteration::Stats::stageName(Stage stage) {
+    switch (stage) {
+    case StagePreprocessInput: return "preprocess-input";
+    case StageMaskBraces: return "mask-braces";
+    case StageAutoCorrect: return "autocorrect";
+    case StageSmartCorrection: return "smart-correction";
+    case StageSegment: return "segment";
+    case StageRestoreBraces: return "restore-braces";
+    default: return "unknown";
+    }
+}
 
 std::string Transliteration::transliterate(const std::string &input) {
-    std::string preprocessed = pImpl->preprocessInput(input);
+    using Timer = Impl::StageTimer;
+    TraceSpan span("transliterate", [&] { return TraceAttributes{{"input_bytes", std::to_string(input.size())}}; });
+    std::string preprocessed;
+    {
+        Timer timer(*pImpl, StagePreprocessInput, input.size());
+        preprocessed = pImpl->preprocessInput(input);
+    }
     std::unordered_map<std::string, std::string> engTokens;
     std::string processed = preprocessed;
-    size_t tokenCount = 1;
-    size_t beginIndex = 0;
-    size_t endIndex = 0;
-    while ((beginIndex = processed.find("{", endIndex)) != std::string::npos) {
-        endIndex = processed.find("}", beginIndex + 1);
-        if (endIndex == std::string::npos) {
-            endIndex = processed.size() - 1;
-        }
-        std::string token =
-            processed.substr(beginIndex, endIndex - beginIndex + 1);
-        std::string mask = "$-" + std::to_string(tokenCount++) + "-$";
-        engTokens[mask] = token.substr(1, token.length() - 2);
-        processed.replace(beginIndex, token.length(), mask);
-        endIndex = beginIndex + mask.length();
+    {
+        Timer timer(*pImpl, StageMaskBraces, processed.size());
+        size_t tokenCount = 1;
+        size_t beginIndex = 0;
+        size_t endIndex = 0;
+        while ((beginIndex = processed.find("{", endIndex)) != std::string::npos) {
+            endIndex = processed.find("}", beginIndex + 1);
+            if (endIndex == std::string::npos) {
+                endIndex = processed.size() - 1;
+            }
+            std::string token =
+                processed.substr(beginIndex, endIndex - beginIndex + 1);
+            std::string mask = "$-" + std::to_string(tokenCount++) + "-$";
+            engTokens[mask] = token.substr(1, token.length() - 2);
+            processed.replace(beginIndex, token.length(), mask);
+            endIndex = beginIndex + mask.length();
+        }
     }
     std::string result;
     std::istringstream iss(processed);
     std::string segment;
+    std::string remembered;
     bool first = true;
     while (std::getline(iss, segment, ' ')) {
         if (!segment.empty()) {
             if (!first)
                 result += " ";
+            if (pImpl->statsEnabled_) ++pImpl->stats_.words;
+#ifdef HAVE_SQLITE3
+            if (pImpl->selectionMemory_ && pImpl->selectionMemory_->lookupSelection(segment, remembered)) {
+                if (pImpl->statsEnabled_) ++pImpl->stats_.selectionHits;
+                pImpl->hitPath(Impl::PathSelectionMemory);
+                result += remembered;
+                first = false;
+                continue;
+            }
+#endif
             if (segment.length() == 1 && std::isdigit(segment[0]) &&
                 !pImpl->enableIndicNumbers_) {
+                pImpl->hitPath(Impl::PathDigitPassthrough);
                 result += segment;
             } else if (segment.length() == 1 && !std::isalnum(segment[0]) &&
                        !pImpl->enableSymbolsTransliteration_) {
+                pImpl->hitPath(Impl::PathSymbolPassthrough);
                 result += segment;
             } else if (segment.length() == 1 && pImpl->charMap_.count(segment)) {
+                if (pImpl->statsEnabled_) {
+                    ++pImpl->stats_.mapLookups;
+                    ++pImpl->stats_.mapHits;
+                }
+                if (pImpl->profiling_) {
+                    pImpl->hitPath(Impl::PathSingleChar);
+                    ++pImpl->mappingHits_[segment];
+                }
                 result += pImpl->charMap_[segment];
             } else {
+                pImpl->hitPath(Impl::PathRules);
                 std::string cleaned = pImpl->preprocess(segment);
+                Timer timer(*pImpl, StageSegment, cleaned.size());
                 result += pImpl->transliterateSegment(cleaned);
             }
             first = false;
         }
     }
-    for (const auto &[mask, original] : engTokens) {
-        std::string translatedMask = pImpl->transliterateSegment(mask);
-        size_t pos = 0;
-        while ((pos = result.find(translatedMask, pos)) != std::string::npos) {
-            result.replace(pos, translatedMask.length(), original);
-            pos += original.length();
+    {
+        Timer timer(*pImpl, StageRestoreBraces, result.size());
+        for (const auto &[mask, original] : engTokens) {
+            std::string translatedMask = pImpl->transliterateSegment(mask, false);
+            size_t pos = 0;
+            while ((pos = result.find(translatedMask, pos)) != std::string::npos) {
+                result.replace(pos, translatedMask.length(), original);
+                pos += original.length();
+            }
         }
     }
+    if (pImpl->statsEnabled_) {
+        ++pImpl->stats_.calls;
+        pImpl->stats_.inputBytes += input.size();
+        pImpl->stats_.outputBytes += result.size();
+    }
+    if (span) span.addEndAttribute("output_bytes", std::to_string(result.size()));
     return result;
 }
 
@@ -803,6 +3133,9 @@ void Transliteration::Impl::parseMappingsToml(const std::string &content) {
         if (!charMap_.count(consoMinusA))
             charMap_[consoMinusA] = val + "्";
     }
+    asciiKeys_ = std::all_of(charMap_.begin(), charMap_.end(), [](const auto &entry) {
+        return findNonAsciiByte(entry.first.data(), entry.first.size()) == entry.first.size();
+    });
 }
 
 std::string Transliteration::Impl::applyAutoCorrection(const std::string &word) const {
@@ -828,6 +3161,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
         // Corrects a word-final 'y' (when not a vowel) to 'ee' for a long vowel sound.
         // Example: User types "gunDy" which might be intended as "gunDee" for गुण्डी.
         if (!isVowel(ec_0) && ec_0 == 'y') {
+            hitRule(RuleFinalYToEe);
             word = word.substr(0, word.length() - 1) + "ee";
         } else if (!(ec_0 == 'a' && ec_1 == 'h' && ec_2 == 'h') &&
                    !(ec_0 == 'a' && ec_1 == 'n' &&
@@ -841,6 +3175,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
             // or nasalizations where the 'a' is often silent.
             if (ec_0 == 'a' && (ec_1 == 'm' || (!isVowel(ec_1) && !isVowel(ec_3) &&
                                                 ec_1 != 'y' && ec_2 != 'e'))) {
+                hitRule(RuleAppendSchwa);
                 word += "a";
             }
         }
@@ -850,6 +3185,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
         // Example: The user types "pani" (पनि), which is often intended to be "panee" (पानी).
         // We specifically avoid this for 'rri' ('ऋ') sequences.
         if (ec_0 == 'i' && !isVowel(ec_1) && !(ec_1 == 'r' && ec_2 == 'r')) {
+            hitRule(RuleFinalIToEe);
             word = word.substr(0, word.length() - 1) + "ee";
         }
     }
@@ -860,6 +3196,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
         if (tolower(word[i]) == 'n' && i > 0 && i + 1 < word.length()) {
             char next_char = tolower(word[i + 1]);
             if (next_char == 'k' || next_char == 'g') {
+                hitRule(RuleVelarNasal);
                 word.replace(i, 1, "ng");
                 i++;
             }
@@ -885,6 +3222,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
     while (pos_ng != std::string::npos) {
         if (pos_ng >= 2 && pos_ng + 2 < word.length() &&
             isVowel(word[pos_ng + 2])) {
+            hitRule(RuleNgGemination);
             word.replace(pos_ng, 2, "ngg");
             pos_ng = word.find("ng", pos_ng + 3);
         } else {
@@ -899,6 +3237,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
             // 'n' before a retroflex stop (T, D) becomes a retroflex nasal 'N' (ण).
             // Example: "ghanTa" -> "ghaNTa" (घन्टा -> घण्टा ).
             if (next == 'T' || next == 'D') {
+                hitRule(RuleRetroflexNasal);
                 word.replace(i, 1, "N");
                 i++;
             }
@@ -906,6 +3245,7 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
             // Example: "kanchan" -> "kañchan" (कन्चन -> कञ्चन).
             else if (next == 'c' && i + 2 < word.size() && word[i + 2] == 'h') {
                 if (!(i + 3 < word.size() && word[i + 3] == 'h')) {
+                    hitRule(RulePalatalNasal);
                     word.replace(i, 1, "ञ्");
                     i++;
                 }
@@ -918,12 +3258,19 @@ std::string Transliteration::Impl::applySmartCorrection(const std::string &input
 std::string Transliteration::Impl::preprocess(const std::string &input) {
     std::string processedWord = input;
     if (enableAutoCorrect_) {
+        StageTimer timer(*this, Transliteration::StageAutoCorrect, processedWord.size());
         std::string autoCorrected = applyAutoCorrection(processedWord);
         if (autoCorrected != processedWord) {
+            if (statsEnabled_) ++stats_.autoCorrectHits;
+            if (profiling_) {
+                hitPath(PathAutoCorrect);
+                ++autoCorrectHits_[processedWord];
+            }
             return autoCorrected;
         }
     }
     if (enableSmartCorrection_) {
+        StageTimer timer(*this, Transliteration::StageSmartCorrection, processedWord.size());
         processedWord = applySmartCorrection(processedWord);
     }
     return processedWord;
@@ -949,7 +3296,12 @@ std::string Transliteration::Impl::preprocessInput(const std::string &input) {
     return out;
 }
 
-std::string Transliteration::Impl::transliterateSegment(const std::string &input) {
+std::string Transliteration::Impl::transliterateSegment(const std::string &input, bool profile) {
+    // Internal calls (brace placeholders) pass profile = false to stay out of the profile.
+    const bool profiling = profiling_ && profile;
+    // Counted in locals so the probe loop stays free of branches on statsEnabled_.
+    std::uint64_t lookups = 0;
+    std::uint64_t hits = 0;
     std::string result;
     std::istringstream splitter(input);
     std::string subSegment;
@@ -958,22 +3310,36 @@ std::string Transliteration::Impl::transliterateSegment(const std::string &input
             std::string subResult;
             std::string rem = subSegment;
             while (!rem.empty()) {
+                if (asciiKeys_ && static_cast<unsigned char>(rem[0]) >= 0x80) {
+                    // No key can match from here, so a run of non-ASCII bytes
+                    // (Devanagari typed in directly) passes through as is.
+                    size_t run = findAsciiByte(rem.data(), rem.size());
+                    if (profiling) hitPath(enableSymbolsTransliteration_ ? PathUnmappedByte : PathSegmentSymbolPassthrough, run);
+                    subResult.append(rem, 0, run);
+                    rem.erase(0, run);
+                    continue;
+                }
                 std::string matched;
                 for (int i = static_cast<int>(rem.size()); i > 0; --i) {
                     std::string part = rem.substr(0, i);
                     if (part.length() == 1 && std::isdigit(part[0]) &&
                         !enableIndicNumbers_) {
+                        if (profiling) hitPath(PathSegmentDigitPassthrough);
                         matched = part;
                         rem.erase(0, i);
                         break;
                     }
                     if (part.length() == 1 && !std::isalnum(part[0]) &&
                         !enableSymbolsTransliteration_) {
+                        if (profiling) hitPath(PathSegmentSymbolPassthrough);
                         matched = part;
                         rem.erase(0, i);
                         break;
                     }
+                    ++lookups;
                     if (charMap_.count(part)) {
+                        ++hits;
+                        if (profiling) ++mappingHits_[part];
                         matched = charMap_[part];
                         rem.erase(0, i);
                         break;
@@ -984,12 +3350,19 @@ std::string Transliteration::Impl::transliterateSegment(const std::string &input
                 } else {
                     std::string singleChar(1, rem[0]);
                     if (std::isdigit(rem[0]) && !enableIndicNumbers_) {
+                        if (profiling) hitPath(PathSegmentDigitPassthrough);
                         subResult += rem[0];
                     } else if (!std::isalnum(rem[0]) && !enableSymbolsTransliteration_) {
+                        if (profiling) hitPath(PathSegmentSymbolPassthrough);
                         subResult += rem[0];
                     } else if (charMap_.count(singleChar)) {
+                        if (profiling) {
+                            hitPath(PathSingleCharFallback);
+                            ++mappingHits_[singleChar];
+                        }
                         subResult += charMap_[singleChar];
                     } else {
+                        if (profiling) hitPath(PathUnmappedByte);
                         subResult += rem[0];
                     }
                     rem.erase(0, 1);
@@ -1007,11 +3380,16 @@ std::string Transliteration::Impl::transliterateSegment(const std::string &input
                      0x8D);
             if (resultEndsWithHalanta && !originalEndsWithHalanta &&
                 subSegment.size() > 1) {
+                if (profiling) hitPath(PathHalantaTrim);
                 subResult.resize(subResult.size() - 3);
             }
             result += subResult;
         }
     }
+    if (statsEnabled_) {
+        stats_.mapLookups += lookups;
+        stats_.mapHits += hits;
+    }
     return result;
 }
 
@@ -0,0 +1,126 @@
+/* The C API's caller-owned buffer convention: a call with a buffer that is
+ * too small reports the size needed, and a retry with that size succeeds. */
+
+#include "test_util.h"
+
+#include <liblekhika/lekhika_c.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SQLITE3
+#include <sqlite3.h>
+#endif
+
+#define DATA_DIR LEKHIKA_SRC_DIR "/core/data"
+
+static void testTransliterate(void) {
+    lekhika_transliterator* t = NULL;
+    CHECK(lekhika_transliterator_new(DATA_DIR, strlen(DATA_DIR), &t) == LEKHIKA_OK);
+
+    const char* input = "namaste nepal";
+    char full[256];
+    size_t fullLen = 0;
+    CHECK(lekhika_transliterate(t, input, strlen(input), full, sizeof(full), &fullLen) == LEKHIKA_OK);
+    CHECK(fullLen > 0 && fullLen == strlen(full));
+
+    /* Too small: nothing usable, but the length needed. */
+    char small[4];
+    size_t len = 0;
+    CHECK(lekhika_transliterate(t, input, strlen(input), small, sizeof(small), &len) == LEKHIKA_ERR_BUFFER_TOO_SMALL);
+    CHECK(len == fullLen);
+    CHECK(strlen(lekhika_last_error()) > 0);
+
+    /* Retry with exactly *out_len + 1 bytes. */
+    char retry[256];
+    size_t retryLen = 0;
+    CHECK(lekhika_transliterate(t, input, strlen(input), retry, len + 1, &retryLen) == LEKHIKA_OK);
+    CHECK(retryLen == fullLen && memcmp(retry, full, fullLen + 1) == 0);
+
+    /* A sizing call with no buffer at all, then a retry with other input:
+     * the result must be for the new input, not the remembered one. */
+    CHECK(lekhika_transliterate(t, input, strlen(input), NULL, 0, &len) == LEKHIKA_ERR_BUFFER_TOO_SMALL);
+    CHECK(len == fullLen);
+    const char* other = "ghar";
+    char otherOut[64];
+    CHECK(lekhika_transliterate(t, other, strlen(other), otherOut, sizeof(otherOut), &len) == LEKHIKA_OK);
+    CHECK(len == strlen(otherOut) && memcmp(otherOut, full, len) != 0);
+
+    /* No room for the NUL: still a success, the bytes are exact. */
+    char exact[256];
+    memset(exact, 'x', sizeof(exact));
+    CHECK(lekhika_transliterate(t, input, strlen(input), exact, fullLen, &len) == LEKHIKA_OK);
+    CHECK(len == fullLen && memcmp(exact, full, fullLen) == 0 && exact[fullLen] == 'x');
+
+    CHECK(lekhika_transliterate(t, NULL, 3, full, sizeof(full), &len) == LEKHIKA_ERR_INVALID_ARGUMENT);
+    lekhika_transliterator_free(t);
+}
+
+static void testSanitize(void) {
+    const char* word = "नमस्ते।";
+    char out[64];
+    size_t len = 0;
+    CHECK(lekhika_sanitize_word(word, strlen(word), out, 2, &len) == LEKHIKA_ERR_BUFFER_TOO_SMALL);
+    CHECK(len > 2);
+    size_t needed = len;
+    CHECK(lekhika_sanitize_word(word, strlen(word), out, needed + 1, &len) == LEKHIKA_OK);
+    CHECK(len == needed && strcmp(out, "नमस्ते") == 0);
+}
+
+#ifdef HAVE_SQLITE3
+static void testDictionary(void) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/c_api_test.akshardb", LEKHIKA_TEST_TMP);
+    remove(path);
+
+    lekhika_dictionary* d = NULL;
+    CHECK(lekhika_dictionary_open(path, strlen(path), &d) == LEKHIKA_OK);
+    const char* words[] = {"कमल", "कलम", "कपाल"};
+    for (int i = 0; i < 3; ++i) {
+        for (int n = 0; n <= i; ++n) {
+            CHECK(lekhika_dictionary_add_word(d, words[i], strlen(words[i])) == LEKHIKA_OK);
+        }
+    }
+
+    /* Sizing call, then the real one: NUL-separated, most frequent first. */
+    size_t len = 0, count = 0;
+    CHECK(lekhika_dictionary_find_words(d, "क", strlen("क"), 10, NULL, 0, &len, &count) == LEKHIKA_ERR_BUFFER_TOO_SMALL);
+    CHECK(count == 3);
+    size_t expected = strlen("कपाल") + strlen("कलम") + strlen("कमल") + 3;
+    CHECK(len == expected);
+    char out[64];
+    CHECK(lekhika_dictionary_find_words(d, "क", strlen("क"), 10, out, len, &len, &count) == LEKHIKA_OK);
+    CHECK(count == 3 && len == expected);
+    const char* p = out;
+    CHECK(strcmp(p, "कपाल") == 0);
+    p += strlen(p) + 1;
+    CHECK(strcmp(p, "कलम") == 0);
+    p += strlen(p) + 1;
+    CHECK(strcmp(p, "कमल") == 0);
+
+    int frequency = 0;
+    CHECK(lekhika_dictionary_word_frequency(d, "कपाल", strlen("कपाल"), &frequency) == LEKHIKA_OK);
+    CHECK(frequency == 3);
+    lekhika_dictionary_free(d);
+
+    /* A trigger that rejects inserts stands in for any failed write. */
+    sqlite3* db = NULL;
+    CHECK(sqlite3_open(path, &db) == SQLITE_OK);
+    CHECK(sqlite3_exec(db, "CREATE TRIGGER reject BEFORE INSERT ON words BEGIN SELECT RAISE(ABORT, 'rejected'); END;",
+                       NULL, NULL, NULL) == SQLITE_OK);
+    sqlite3_close(db);
+    CHECK(lekhika_dictionary_open(path, strlen(path), &d) == LEKHIKA_OK);
+    CHECK(lekhika_dictionary_add_word(d, "घर", strlen("घर")) == LEKHIKA_ERR_FAILED);
+    CHECK(strstr(lekhika_last_error(), "rejected") != NULL);
+    lekhika_dictionary_free(d);
+}
+#endif
+
+int main(void) {
+    testTransliterate();
+    testSanitize();
+#ifdef HAVE_SQLITE3
+    testDictionary();
+#endif
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Change log and delta sync between two dictionaries (exportDelta/importDelta).
+
+#include "test_util.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path kDir = fs::path(LEKHIKA_TEST_TMP) / "delta_sync_test.tmp";
+
+std::string freshDb(const char* name) {
+    fs::path path = kDir / name;
+    fs::remove(path);
+    return path.string();
+}
+
+std::string file(const char* name) { return (kDir / name).string(); }
+
+// A log enabled on an empty dictionary covers every word, so deltas carry
+// adds, frequency changes and deletes, and imports are not echoed back.
+void testRoundTrip() {
+    DictionaryManager a(freshDb("a.akshardb"));
+    DictionaryManager b(freshDb("b.akshardb"));
+    CHECK(a.getChangeSequence() == 0);
+    CHECK(b.getChangeSequence() == 0);
+
+    a.addWord("घर");
+    a.addWord("घर");
+    a.addWord("कमल");
+    a.addWord("नदी");
+    a.removeWord("नदी");
+    long long seq = a.exportDelta(0, file("1.delta"));
+    CHECK(seq > 0);
+    CHECK(seq == a.getChangeSequence());
+
+    CHECK(b.importDelta(file("1.delta")) == 3); // The delete of नदी is sent too
+    CHECK(b.getWordFrequency("घर") == a.getWordFrequency("घर"));
+    CHECK(b.getWordFrequency("कमल") == 1);
+    CHECK(b.getWordFrequency("नदी") == -1);
+
+    // Changes after the last sync only.
+    CHECK(a.updateWordFrequency("कमल", 10));
+    a.removeWord("घर");
+    a.addWord("पानी");
+    long long next = a.exportDelta(seq, file("2.delta"));
+    CHECK(next > seq);
+    CHECK(b.importDelta(file("2.delta")) == 3);
+    CHECK(b.getWordFrequency("कमल") == 10);
+    CHECK(b.getWordFrequency("घर") == -1);
+    CHECK(b.getWordFrequency("पानी") == 1);
+
+    // Nothing new: an empty delta covering up to the same sequence.
+    CHECK(a.exportDelta(next, file("3.delta")) == next);
+    CHECK(b.importDelta(file("3.delta")) == 0);
+
+    // b's imports are not local changes, so they are not sent back.
+    b.exportDelta(0, file("echo.delta"));
+    CHECK(a.importDelta(file("echo.delta")) == 0);
+    CHECK(a.getWordFrequency("कमल") == 10);
+}
+
+// Words added before the log existed are not in it, so a full delta from a
+// pre-populated dictionary, or one reaching back past a prune, is refused.
+void testFloor() {
+    DictionaryManager d(freshDb("floor.akshardb"));
+    d.addWord("घर");
+    d.addWord("कमल");
+    CHECK_THROWS(d.exportDelta(0, file("floor.delta")));
+    long long start = d.getChangeSequence();
+    CHECK(start == 1);
+    CHECK(d.exportDelta(start, file("floor.delta")) == start);
+
+    d.addWord("पानी");
+    long long seq = d.exportDelta(start, file("floor.delta"));
+    CHECK(seq > start);
+    d.addWord("नदी");
+    d.pruneChangeLog(seq);
+    CHECK_THROWS(d.exportDelta(start, file("floor.delta")));
+    CHECK(d.exportDelta(seq, file("floor.delta")) > seq);
+    CHECK(d.getChangeSequence() > seq);
+}
+
+void testCorruptFile() {
+    DictionaryManager a(freshDb("corrupt_a.akshardb"));
+    DictionaryManager b(freshDb("corrupt_b.akshardb"));
+    a.getChangeSequence();
+    a.addWord("घर");
+    a.addWord("कमल");
+    a.exportDelta(0, file("full.delta"));
+
+    // Cut off in the middle of the last record: nothing is applied.
+    std::string bytes;
+    {
+        std::ifstream in(file("full.delta"), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    std::ofstream(file("cut.delta"), std::ios::binary) << bytes.substr(0, bytes.size() - 2);
+    CHECK_THROWS(b.importDelta(file("cut.delta")));
+    CHECK(b.getWordFrequency("घर") == -1);
+
+    std::ofstream(file("junk.delta"), std::ios::binary) << "not a delta";
+    CHECK_THROWS(b.importDelta(file("junk.delta")));
+    CHECK_THROWS(b.importDelta(file("missing.delta")));
+}
+
+} // namespace
+
+int main() {
+    fs::create_directories(kDir);
+    testRoundTrip();
+    testFloor();
+    testCorruptFile();
+    return 0;
+}
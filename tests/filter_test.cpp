@@ -0,0 +1,97 @@
+// runFilter() (lekhika-cli filter): with several workers and many chunks in
+// flight, every record's result comes back in input order.
+
+#include "test_util.h"
+
+#include "lekhika_filter.h"
+
+#include <liblekhika/lekhika_core.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path kDir = fs::path(LEKHIKA_TEST_TMP) / "filter_test.tmp";
+const std::string kDataDir = (fs::path(LEKHIKA_SRC_DIR) / "core" / "data").string();
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+// Runs the filter over `input` and returns what it wrote to stdout.
+std::string filter(const FilterOptions& options, const std::string& input) {
+    const fs::path in = kDir / "in", out = kDir / "out";
+    std::ofstream(in, std::ios::binary) << input;
+    CHECK(std::freopen(in.c_str(), "rb", stdin));
+    CHECK(std::freopen(out.c_str(), "wb", stdout));
+    CHECK(runFilter(options) == 0);
+    CHECK(std::fclose(stdout) == 0);
+    return readFile(out);
+}
+
+// Several megabytes of records of uneven cost, so that chunks finish out
+// of order; the last record has no delimiter.
+std::vector<std::string> records() {
+    static const char* kWords[] = {"namaste", "ghar", "kamal", "nepal", "pustak", "saathi", "paani"};
+    std::vector<std::string> result;
+    for (int i = 0; i < 120000; ++i) {
+        std::string record = kWords[i % 7] + std::string(" ") + std::to_string(i);
+        if (i % 5000 == 0) {
+            for (int n = 0; n < 50; ++n) record += std::string(" ") + kWords[n % 7];
+        }
+        if (i % 9973 == 0) record.clear();
+        result.push_back(record);
+    }
+    return result;
+}
+
+void testTransliterateOrder() {
+    const std::vector<std::string> input = records();
+    Transliteration reference(kDataDir);
+    std::string joined, expected;
+    for (size_t i = 0; i < input.size(); ++i) {
+        joined += input[i];
+        if (i + 1 < input.size()) joined += '\n';
+        expected += reference.transliterate(input[i]) + '\n';
+    }
+    CHECK(joined.size() > 4 * 256 * 1024);
+
+    FilterOptions options;
+    options.dataDir = kDataDir;
+    options.jobs = 4;
+    CHECK(filter(options, joined) == expected);
+}
+
+void testValidateOrder() {
+    std::string input, expected;
+    for (int i = 0; i < 200000; ++i) {
+        bool valid = (i / 3) % 2 == 0;
+        input += valid ? "नमस्ते" : "abc";
+        input += '\0';
+        expected += valid ? '1' : '0';
+        expected += '\0';
+    }
+    FilterOptions options;
+    options.dataDir = kDataDir;
+    options.jobs = 3;
+    options.validate = true;
+    options.delimiter = '\0';
+    CHECK(filter(options, input) == expected);
+}
+
+} // namespace
+
+int main() {
+    fs::create_directories(kDir);
+    testTransliterateOrder();
+    testValidateOrder();
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Opening a format 1.0 dictionary: added key columns and indexes, filled keys,
+// and rows without keys (written by older versions or other tools).
+
+#include "test_util.h"
+
+#include <liblekhika/lekhika_core.h>
+#include <sqlite3.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path kDir = fs::path(LEKHIKA_TEST_TMP) / "schema_upgrade_test.tmp";
+
+void exec(sqlite3* db, const char* sql) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &err) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n", err);
+        exit(1);
+    }
+}
+
+std::int64_t queryInt(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    CHECK(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    CHECK(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK);
+    CHECK(sqlite3_step(stmt) == SQLITE_ROW);
+    std::int64_t value = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return value;
+}
+
+void execOn(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    CHECK(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    exec(db, sql);
+    sqlite3_close(db);
+}
+
+// The schema written by format 1.0, with its redundant idx_word.
+std::string createFormat10(const char* name) {
+    fs::path path = kDir / name;
+    fs::remove(path);
+    execOn(path.string(),
+           "CREATE TABLE words ("
+           "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+           "word TEXT NOT NULL UNIQUE,"
+           "frequency INTEGER NOT NULL DEFAULT 1);"
+           "CREATE INDEX idx_word ON words(word);"
+           "CREATE TABLE meta (key TEXT PRIMARY KEY, value TEXT);"
+           "INSERT INTO meta (key, value) VALUES ('format_version', '1.0');"
+           "INSERT INTO words (word, frequency) VALUES ('पानी', 4), ('कमल', 7), ('घर', 2), ('अनार', 1), ('कलम', 3);");
+    return path.string();
+}
+
+void testUpgrade() {
+    const std::string path = createFormat10("old.akshardb");
+    {
+        DictionaryManager dict(path);
+        CHECK(dict.getWordFrequency("कमल") == 7);
+        CHECK(dict.findWords("क", 10) == (std::vector<std::string>{"कमल", "कलम"}));
+
+        auto all = dict.getAllWords();
+        CHECK(all.size() == 5);
+        CHECK(all[0].first == "अनार");
+        CHECK(all[1].first == "कमल");
+        CHECK(all[2].first == "कलम");
+        CHECK(all[3].first == "घर");
+        CHECK(all[4].first == "पानी");
+
+        dict.addWord("खरायो");
+        CHECK(dict.findWords("ख", 10) == std::vector<std::string>{"खरायो"});
+    }
+    CHECK(queryInt(path, "SELECT count(*) FROM pragma_table_info('words') WHERE name IN ('sort_key', 'word_key');") == 2);
+    CHECK(queryInt(path, "SELECT count(*) FROM sqlite_master WHERE name = 'idx_word';") == 0);
+    CHECK(queryInt(path, "SELECT count(*) FROM sqlite_master WHERE name IN ('idx_sort_key', 'idx_word_key', 'selections');") == 3);
+    // A small dictionary gets all its keys while being opened.
+    CHECK(queryInt(path, "SELECT count(*) FROM words WHERE word_key IS NULL OR sort_key IS NULL;") == 0);
+    // The change log is opt-in, not part of the upgrade.
+    CHECK(queryInt(path, "SELECT count(*) FROM sqlite_master WHERE name = 'changes';") == 0);
+
+    // Upgrading is idempotent.
+    DictionaryManager again(path);
+    CHECK(again.getAllWords().size() == 6);
+}
+
+// Rows inserted without keys are still found by prefix, and maintain()
+// computes their keys.
+void testRowsWithoutKeys() {
+    const std::string path = createFormat10("nokeys.akshardb");
+    DictionaryManager dict(path);
+    execOn(path, "INSERT INTO words (word, frequency) VALUES ('कपाल', 9), ('नदी', 1);");
+    CHECK(queryInt(path, "SELECT count(*) FROM words WHERE word_key IS NULL;") == 2);
+
+    CHECK(dict.findWords("क", 10) == (std::vector<std::string>{"कपाल", "कमल", "कलम"}));
+    CHECK(dict.findWords("नदी", 10) == std::vector<std::string>{"नदी"});
+
+    DictionaryManager::MaintenanceReport report;
+    for (int i = 0; i < 10 && !report.complete; ++i) {
+        report = dict.maintain(std::chrono::milliseconds(200));
+    }
+    CHECK(report.complete);
+    CHECK(queryInt(path, "SELECT count(*) FROM words WHERE word_key IS NULL OR sort_key IS NULL;") == 0);
+    CHECK(dict.findWords("क", 10) == (std::vector<std::string>{"कपाल", "कमल", "कलम"}));
+}
+
+} // namespace
+
+int main() {
+    fs::create_directories(kDir);
+    testUpgrade();
+    testRowsWithoutKeys();
+    return 0;
+}
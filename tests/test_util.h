@@ -0,0 +1,25 @@
+#pragma once
+/* Checks for the unit tests. Unlike assert(), they stay active in release builds. */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+
+#ifdef __cplusplus
+/* Passes if `expr` throws a std::exception. */
+#define CHECK_THROWS(expr)                                                       \
+    do {                                                                         \
+        bool thrown_ = false;                                                    \
+        try { (void)(expr); } catch (const std::exception&) { thrown_ = true; }  \
+        if (!thrown_) {                                                          \
+            fprintf(stderr, "%s:%d: expected an exception: %s\n", __FILE__, __LINE__, #expr); \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+#endif